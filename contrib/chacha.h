@@ -32,6 +32,8 @@
 
 #include <cstdint>
 #include <limits>
+#include <algorithm>
+#include <cstring>
 
 template<size_t R>
 class ChaCha {
@@ -70,6 +72,9 @@ public:
     }
     double gen_double();
     void discard(unsigned long long n);
+
+    /// Fill out[0..n) with the next n outputs; same as n calls to operator()
+    void fill(uint32_t* out, size_t n);
     
     template<size_t R_> friend bool operator==(const ChaCha<R_>& lhs, const ChaCha<R_>& rhs);
     template<size_t R_> friend bool operator!=(const ChaCha<R_>& lhs, const ChaCha<R_>& rhs);
@@ -156,6 +161,19 @@ inline double ChaCha<R>::gen_double() {
     return (x << 21) * v;
 }
 
+template<size_t R>
+inline void ChaCha<R>::fill(uint32_t* out, size_t n) {
+    while (n > 0) {
+        size_t idx = ctr % 16;
+        if (idx == 0) generate_block();
+        size_t len = std::min<size_t>(16 - idx, n);
+        memcpy(out, block + idx, len * sizeof(uint32_t));
+        ctr += len;
+        out += len;
+        n -= len;
+    }
+}
+
 template<size_t R>
 inline void ChaCha<R>::discard(unsigned long long n) {
     int idx = ctr % 16;
@@ -87,6 +87,13 @@ public:
      * infantDeaths arrays. */
     void updateInfantDeaths( SimTime age );
     
+    /** True when update() would have no effect on a host without parasites:
+     * the host is not doomed and no clinical events are pending (used by
+     * LAZY_QUIESCENT_HUMANS). */
+    virtual bool isQuiescent() const {
+        return doomed == NOT_DOOMED;
+    }
+    
     /** Special option to allow reports not to be delivered for existing cases
      * (within health-system-memory and not new cases). */
     virtual bool isExistingCase() =0;
@@ -101,6 +108,12 @@ public:
         latestReport.flush();
     }
     
+    /// Report the last episode if it can no longer change (see
+    /// Episode::flushExpired). Does not affect output.
+    inline void flushExpiredReports (){
+        latestReport.flushExpired();
+    }
+    
     /// Checkpointing
     template<class S>
     void operator& (S& stream) {
@@ -35,6 +35,13 @@ void Episode::flush() {
     time = SimTime::never();
 }
 
+void Episode::flushExpired() {
+    // same condition as in update(), evaluated for the next step
+    if( time + ClinicalModel::hsMemory() < sim::now() ){
+        flush();
+    }
+}
+
 
 void Episode::update (const Host::Human& human, Episode::State newState)
 {
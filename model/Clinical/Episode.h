@@ -87,6 +87,11 @@ public:
     /// Report anything pending, as on destruction
     void flush();
     
+    /** Report the pending episode if health-system memory has expired (i.e.
+     * no further events can be added to it). This does not affect output,
+     * since such an episode is reported anyway on the next update. */
+    void flushExpired();
+    
     /** Report an episode, its severity, and any outcomes it entails.
      *
      * @param human The human whose info is being reported
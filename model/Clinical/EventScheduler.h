@@ -49,6 +49,9 @@ public:
     ClinicalEventScheduler (double tSF);
     
     virtual bool isExistingCase();
+    virtual bool isQuiescent() const {
+        return ClinicalModel::isQuiescent() && pgState == Episode::NONE;
+    }
 
 protected:
     virtual void doClinicalUpdate (Human& human, double ageYears);
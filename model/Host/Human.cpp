@@ -39,12 +39,15 @@ namespace OM { namespace Host {
     using interventions::ComponentId;
     
     bool surveyOnlyNewEp = false;
+bool Human::counterRng = false;
+uint64_t Human::nextSerial = 0;
 
 // -----  Static functions  -----
 
 void Human::init( const Parameters& parameters, const scnXml::Scenario& scenario ){    // static
     HumanHet::init();
     surveyOnlyNewEp = scenario.getMonitoring().getSurveyOptions().getOnlyNewEpisode();
+    counterRng = util::ModelOptions::option( util::COUNTER_BASED_HUMAN_RNG );
     
     const scnXml::Model& model = scenario.getModel();
     // Init models used by humans:
@@ -61,14 +64,25 @@ void Human::init( const Parameters& parameters, const scnXml::Scenario& scenario
 Human::Human(SimTime dateOfBirth) :
     infIncidence(InfectionIncidenceModel::createModel()),
     m_rng(util::master_RNG),
+    m_rngKey{0, 0},
+    m_rngPos(~uint64_t(0)),
     m_DOB(dateOfBirth),
+    m_serial(nextSerial++),
     m_remove(false),
     m_cohortSet(0),
-    nextCtsDist(0)
+    m_subPopNextExp(SimTime::future()),
+    m_sleepingSince(SimTime::never())
 {
     // Initial humans are created at time 0 and may have DOB in past. Otherwise DOB must be now.
     assert( m_DOB == sim::nowOrTs1() || (sim::now() == SimTime::zero() && m_DOB < sim::now()) );
     
+    if( counterRng ){
+        // the key identifies this human's streams
+        m_rngKey[0] = util::master_RNG.gen_seed();
+        m_rngKey[1] = util::master_RNG.gen_seed();
+        seekRng( true );
+    }
+    
     HumanHet het = HumanHet::sample(m_rng);
     withinHostModel = WithinHost::WHInterface::createWithinHostModel( m_rng, het.comorbidityFactor );
     auto iiFactor = infIncidence->getAvailabilityFactor(m_rng, 1.0);
@@ -76,28 +90,80 @@ Human::Human(SimTime dateOfBirth) :
     clinicalModel = Clinical::ClinicalModel::createClinicalModel (het.treatmentSeekingFactor);
 }
 
+Human::Human(istream& stream) :
+    infIncidence(InfectionIncidenceModel::createModel()),
+    m_rng(0, 0),
+    m_rngKey{0, 0},
+    m_rngPos(~uint64_t(0)),
+    m_DOB(SimTime::never()),
+    m_serial(nextSerial++),
+    m_remove(false),
+    m_cohortSet(0),
+    m_subPopNextExp(SimTime::future()),
+    m_sleepingSince(SimTime::never())
+{
+    // Heterogeneity factors are checkpointed by the sub-models, so neutral
+    // values do here. Samples drawn from m_rng during construction are
+    // likewise overwritten, as is m_rng itself.
+    withinHostModel = WithinHost::WHInterface::createWithinHostModel( m_rng, 1.0 );
+    clinicalModel = Clinical::ClinicalModel::createClinicalModel( 1.0 );
+    *this & stream;
+    for( auto it = m_subPopExp.begin(); it != m_subPopExp.end(); ++it ){
+        SubPopIndex::add( it->first.id, m_serial );
+    }
+}
+
 Human::Human(SimTime dateOfBirth, int dummy) :
     withinHostModel(nullptr),
     infIncidence(nullptr),
     clinicalModel(nullptr),
     m_rng(0, 0),
+    m_rngKey{0, 0},
+    m_rngPos(~uint64_t(0)),
     m_DOB(dateOfBirth),
+    m_serial(nextSerial++),
     m_remove(false),
     m_cohortSet(0),
-    nextCtsDist(0)
+    m_subPopNextExp(SimTime::future()),
+    m_sleepingSince(SimTime::never())
 {}
 
+void Human::seekRng( bool construction ){
+    // Three streams per time step: construction, deployment (between steps,
+    // when nowOrTs0() == nowOrTs1()) and update.
+    SimTime t0 = sim::nowOrTs0();
+    uint64_t phase = construction ? 0 : (t0 == sim::nowOrTs1() ? 1 : 2);
+    uint64_t pos = 3 * static_cast<uint64_t>(t0.inSteps()) + phase;
+    if( pos != m_rngPos ){
+        m_rng.seed_counter( m_rngKey[0], m_rngKey[1], pos );
+        m_rngPos = pos;
+    }
+}
+
 
 // -----  Non-static functions: per-time-step update  -----
 
 vector<double> EIR_per_genotype;        // cache (not thread safe)
 
 void Human::update(const Transmission::TransmissionModel& transmission) {
+    if( updateInfection( transmission, false ) ) updateClinical();
+}
+
+bool Human::updateStart(const Transmission::TransmissionModel& transmission) {
+    return updateInfection( transmission, true );
+}
+
+void Human::updateFinish() {
+    withinHostModel->updateFinish();
+    updateClinical();
+}
+
+bool Human::updateInfection(const Transmission::TransmissionModel& transmission, bool batched) {
     // For integer age checks we use age0 to e.g. get 73 steps comparing less than 1 year old
     SimTime age0 = age(sim::ts0());
     if (clinicalModel->isDead(age0)) {
         m_remove = true;
-        return;
+        return false;
     }
     
     util::streamValidate( age0.inDays() );
@@ -109,17 +175,21 @@ void Human::update(const Transmission::TransmissionModel& transmission) {
     // monitoringAgeGroup is the group for the start of the time step.
     monitoringAgeGroup.update( age0 );
     // check sub-pop expiry
-    for( auto expIt = m_subPopExp.begin(), expEnd = m_subPopExp.end(); expIt != expEnd; ) {
-        if( !(expIt->second >= sim::ts0()) ){       // membership expired
-            // don't flush reports
-            // report removal due to expiry
-            mon::reportEventMHI( mon::MHR_SUB_POP_REM_TOO_OLD, *this, 1 );
-            m_cohortSet = mon::updateCohortSet( m_cohortSet, expIt->first, false );
-            // erase element, but continue iteration
-            expIt = m_subPopExp.erase( expIt );
-        }else{
-            ++expIt;
+    if( m_subPopNextExp < sim::ts0() ){
+        for( auto expIt = m_subPopExp.begin(); expIt != m_subPopExp.end(); ) {
+            if( !(expIt->second >= sim::ts0()) ){       // membership expired
+                // don't flush reports
+                // report removal due to expiry
+                mon::reportEventMHI( mon::MHR_SUB_POP_REM_TOO_OLD, *this, 1 );
+                m_cohortSet = mon::updateCohortSet( m_cohortSet, expIt->first, false );
+                SubPopIndex::remove( expIt->first.id, m_serial );
+                // erase element, but continue iteration
+                expIt = m_subPopExp.erase( expIt );
+            }else{
+                ++expIt;
+            }
         }
+        updateSubPopNextExp();
     }
     // ageYears1 used only in PerHost::relativeAvailabilityAge(); difference to age0 should be minor
     double EIR = transmission.getEIR( *this, age0, ageYears1,
@@ -127,16 +197,59 @@ void Human::update(const Transmission::TransmissionModel& transmission) {
     int nNewInfs = infIncidence->numNewInfections( *this, EIR );
     
     // ageYears1 used when medicating drugs (small effect) and in immunity model (which was parameterised for it)
-    withinHostModel->update(m_rng, nNewInfs, EIR_per_genotype, ageYears1,
-            _vaccine.getFactor(interventions::Vaccine::BSV));
-    
+    if( batched ){
+        withinHostModel->updateStart(rng(), nNewInfs, EIR_per_genotype, ageYears1,
+                _vaccine.getFactor(interventions::Vaccine::BSV), m_rngKey);
+    }else{
+        withinHostModel->update(rng(), nNewInfs, EIR_per_genotype, ageYears1,
+                _vaccine.getFactor(interventions::Vaccine::BSV));
+    }
+    return true;
+}
+
+void Human::updateClinical() {
+    SimTime age0 = age(sim::ts0());
+    double ageYears1 = age(sim::ts1()).inYears();
     // ageYears1 used to get case fatality and sequelae probabilities, determine pathogenesis
     clinicalModel->update( *this, ageYears1, age0 == SimTime::zero() );
     clinicalModel->updateInfantDeaths( age0 );
 }
 
+bool Human::isQuiescent() const{
+    // infant deaths are tracked per step, so infants are never quiescent
+    return age(sim::ts1()) >= SimTime::oneYear()
+        && withinHostModel->isQuiescent()
+        && clinicalModel->isQuiescent()
+        && !perHostTransmission.hasActiveInterv( interventions::Component::ITN );
+}
+
+bool Human::updateSleeping(const Transmission::TransmissionModel& transmission){
+    SimTime age0 = age(sim::ts0());
+    if( age0 >= sim::maxHumanAge() || m_subPopNextExp < sim::ts0() )
+        return false;
+    transmission.countZeroEIRHost( age0 );
+    return true;
+}
+
+void Human::catchUp(){
+    if( !isSleeping() ) return;
+    // skipped updates are those with ts0 in [m_sleepingSince, nowOrTs0())
+    int steps = (sim::nowOrTs0() - m_sleepingSince).inSteps();
+    if( steps > 0 ){
+        withinHostModel->catchUpQuiescent( steps );
+        monitoringAgeGroup.update( age(sim::nowOrTs0() - SimTime::oneTS()) );
+    }
+    m_sleepingSince = sim::nowOrTs0();
+}
+
+void Human::wake(){
+    catchUp();
+    m_sleepingSince = SimTime::never();
+}
+
 void Human::addInfection(){
-    withinHostModel->importInfection(m_rng);
+    wake();
+    withinHostModel->importInfection(rng());
 }
 
 void Human::clearImmunity(){
@@ -164,14 +277,28 @@ void Human::summarize() {
 
 void Human::reportDeployment( ComponentId id, SimTime duration ){
     if( duration <= SimTime::zero() ) return; // nothing to do
-    m_subPopExp[id] = sim::nowOrTs1() + duration;
+    SimTime expiry = sim::nowOrTs1() + duration;
+    auto it = findSubPop( id );
+    if( it != m_subPopExp.end() && it->first == id ){
+        it->second = expiry;
+    }else{
+        m_subPopExp.insert( it, make_pair( id, expiry ) );
+        SubPopIndex::add( id.id, m_serial );
+    }
+    m_subPopNextExp = std::min( m_subPopNextExp, expiry );
     m_cohortSet = mon::updateCohortSet( m_cohortSet, id, true );
 }
+void Human::updateSubPopNextExp(){
+    m_subPopNextExp = SimTime::future();
+    for( auto it = m_subPopExp.begin(); it != m_subPopExp.end(); ++it ){
+        m_subPopNextExp = std::min( m_subPopNextExp, it->second );
+    }
+}
 void Human::removeFirstEvent( interventions::SubPopRemove::RemoveAtCode code ){
     const vector<ComponentId>& removeAtList = interventions::removeAtIds[code];
     for( auto it = removeAtList.begin(), end = removeAtList.end(); it != end; ++it ){
-        auto expIt = m_subPopExp.find( *it );
-        if( expIt != m_subPopExp.end() ){
+        auto expIt = findSubPop( *it );
+        if( expIt != m_subPopExp.end() && expIt->first == *it ){
             if( expIt->second > sim::nowOrTs0() ){
                 // removeFirstEvent() is used for onFirstBout, onFirstTreatment
                 // and onFirstInfection cohort options. Health system memory must
@@ -184,6 +311,7 @@ void Human::removeFirstEvent( interventions::SubPopRemove::RemoveAtCode code ){
             }
             m_cohortSet = mon::updateCohortSet( m_cohortSet, expIt->first, false );
             // remove (affects reporting, restrictToSubPop and cumulative deployment):
+            SubPopIndex::remove( expIt->first.id, m_serial );
             m_subPopExp.erase( expIt );
         }
     }
@@ -193,4 +321,14 @@ void Human::flushReports (){
     clinicalModel->flushReports();
 }
 
+void Human::removeFromIndex(){
+    for( auto it = m_subPopExp.begin(); it != m_subPopExp.end(); ++it ){
+        SubPopIndex::remove( it->first.id, m_serial );
+    }
+}
+void Human::resetIndex(){
+    nextSerial = 0;
+    SubPopIndex::clear();
+}
+
 } }
@@ -25,8 +25,10 @@
 #include "InfectionIncidenceModel.h"
 #include "mon/AgeGroup.h"
 #include "interventions/HumanComponents.h"
+#include "Host/SubPopIndex.h"
 #include "util/checkpoint_containers.h"
-#include <map>
+#include <vector>
+#include <algorithm>
 
 class UnittestUtil;
 namespace scnXml {
@@ -59,6 +61,13 @@ public:
    * @param dateOfBirth date of birth (usually start of next time step) */
   Human(SimTime dateOfBirth);
   
+  /** Construct a human from a checkpoint.
+   * 
+   * Unlike the above, this does not sample heterogeneity or seed from the
+   * master RNG: sub-models are only created with the right types, then all
+   * state is read from the stream. */
+  explicit Human(istream& stream);
+  
   /// Allow move construction
   Human(Human&&) = default;
   Human& operator=(Human&&) = default;
@@ -77,17 +86,62 @@ public:
       withinHostModel & stream;
       clinicalModel & stream;
       m_rng.checkpoint(stream);
+      m_rngKey[0] & stream;
+      m_rngKey[1] & stream;
+      m_rngPos & stream;
       m_DOB & stream;
       _vaccine & stream;
       monitoringAgeGroup & stream;
       m_cohortSet & stream;
-      nextCtsDist & stream;
       m_subPopExp & stream;
+      m_sleepingSince & stream;
+      updateSubPopNextExp();
   }
   //@}
   
   /// Main human update method.
   void update(const Transmission::TransmissionModel& transmission);
+  
+  /** @brief Batched update (BATCHED_DESCRIPTIVE_UPDATE)
+   * 
+   * update() in two parts: updateStart() for all humans, then
+   * WithinHost::DescriptiveBatch::sweep(), then updateFinish() for each human
+   * for which updateStart() returned true (false means the human died). */
+  //@{
+  bool updateStart(const Transmission::TransmissionModel& transmission);
+  void updateFinish();
+  //@}
+  
+  /** @brief Skipping updates of quiescent humans (LAZY_QUIESCENT_HUMANS)
+   * 
+   * While the EIR is zero, a quiescent human (see isQuiescent()) may sleep:
+   * its updates are skipped. catchUp() must be called before anything else
+   * reads the human's state, and wake() before anything modifies it. */
+  //@{
+  /** True if, given zero EIR, this human's updates from the next step would
+   * only decay immunity. Only for use just after update(). */
+  bool isQuiescent() const;
+  
+  /** Skip updates from the next step on. Requires isQuiescent(). */
+  inline void sleep(){ m_sleepingSince = sim::ts1(); }
+  
+  inline bool isSleeping() const{ return m_sleepingSince != SimTime::never(); }
+  
+  /** Called instead of update() for a sleeping human while the EIR is zero.
+   * 
+   * @returns false if the human must be woken (wake() then update()) to
+   *    die or to leave a sub-population this step */
+  bool updateSleeping(const Transmission::TransmissionModel& transmission);
+  
+  /** Apply all skipped updates, if sleeping. Called during or between
+   * updates; the human stays asleep (results do not depend on whether or
+   * when this is called). */
+  void catchUp();
+  
+  /** Catch up (as above) and stop sleeping; required before changing the
+   * human's state. */
+  void wake();
+  //@}
   //@}
   
   ///@brief Deploy "intervention" functions
@@ -97,7 +151,11 @@ public:
   void reportDeployment( interventions::ComponentId id, SimTime duration );
   
   inline void removeFromSubPop( interventions::ComponentId id ){
-      m_subPopExp.erase( id );
+      auto it = findSubPop( id );
+      if( it != m_subPopExp.end() && it->first == id ){
+          m_subPopExp.erase( it );
+          SubPopIndex::remove( id.id, m_serial );
+      }
   }
   
   /// Resets immunity
@@ -112,31 +170,29 @@ public:
     bool remove() { return m_remove; }
     
     /// Get access to the RNG
-    inline LocalRng& rng() { return m_rng; }
+    inline LocalRng& rng() {
+        if( counterRng ) seekRng( false );
+        return m_rng;
+    }
     
     /** Get human's age with respect to some time. */
     inline SimTime age( SimTime time )const{ return time - m_DOB; }
     /** Date of birth. */
     inline SimTime getDateOfBirth() const{ return m_DOB; }
+    /** Serial number: unique, and increasing in population order (see
+     * SubPopIndex). */
+    inline uint64_t serial() const{ return m_serial; }
   
   /** Return true if human is a member of the sub-population.
    * 
    * @param id Sub-population identifier. */
   inline bool isInSubPop( interventions::ComponentId id )const{
-      auto it = m_subPopExp.find( id );
-      if( it == m_subPopExp.end() ) return false;       // no history of membership
+      auto it = findSubPop( id );
+      if( it == m_subPopExp.end() || !(it->first == id) ) return false;       // no history of membership
       else return it->second > sim::nowOrTs0();   // added: has expired?
   }
   /** Return the cohort set. */
   inline uint32_t cohortSet()const{ return m_cohortSet; }
-  
-  /// Return the index of next continuous intervention to be deployed
-  inline uint32_t getNextCtsDist()const{ return nextCtsDist; }
-  /// Increment then return index of next continuous intervention to deploy
-  inline uint32_t incrNextCtsDist() {
-      nextCtsDist += 1;
-      return nextCtsDist;
-  }
   //@}
   
   //! Summarize the state of a human individual.
@@ -150,6 +206,20 @@ public:
   /// Flush any information pending reporting. Should only be called at destruction.
   void flushReports ();
   
+  /** Remove this human's entries from SubPopIndex. Called when the human is
+   * removed from the population. */
+  void removeFromIndex();
+  
+  /** Restart serial numbers and clear SubPopIndex; called before loading a
+   * population from a checkpoint. */
+  static void resetIndex();
+  
+  /// Flush information pending reporting which can no longer change.
+  /// May be called between updates; does not affect output.
+  inline void flushExpiredReports (){
+      clinicalModel->flushExpiredReports();
+  }
+  
   ///@brief Access to sub-models
   //@{
   /// The WithinHostModel models parasite density and immunity
@@ -190,6 +260,18 @@ private:
   /// Param 'dummy' isn't used but is just to allow overloading against usual constructor
   Human(SimTime dateOfBirth, int dummy);
   
+  /** With COUNTER_BASED_HUMAN_RNG, re-seed m_rng on first use in a new
+   * phase (construction, between steps or update) of a time step. */
+  void seekRng( bool construction );
+  
+  /** Parts of update(): everything up to and including the within-host
+   * update (returns false if the human died), then the clinical update. */
+  bool updateInfection(const Transmission::TransmissionModel& transmission, bool batched);
+  void updateClinical();
+  
+  /// True when using COUNTER_BASED_HUMAN_RNG
+  static bool counterRng;
+  
   /// The InfectionIncidenceModel translates per-host EIR into new infections
   unique_ptr<InfectionIncidenceModel> infIncidence;
   
@@ -200,8 +282,15 @@ private:
   //@}
   
   LocalRng m_rng;
+  /// Key and current position (see seekRng()) of the counter-based stream;
+  /// only used with COUNTER_BASED_HUMAN_RNG
+  uint64_t m_rngKey[2];
+  uint64_t m_rngPos;
   
   SimTime m_DOB;        // date of birth; humans are always born at the end of a time step
+  /// See serial(). Not checkpointed: humans are renumbered when loaded.
+  uint64_t m_serial;
+  static uint64_t nextSerial;
   bool m_remove;    // TODO: we only need this because dead-person replacement can be delayed by 2 steps
   
   /// Vaccines
@@ -215,12 +304,22 @@ private:
   uint32_t m_cohortSet;
   //@}
   
-  /// The next continuous distribution in the series
-  uint32_t nextCtsDist;
+  /** Memberships are few per human, so a vector sorted by component id is
+   * used (cheaper to search, copy and iterate than a map). */
+  typedef std::vector<std::pair<interventions::ComponentId,SimTime>> SubPopT;
+  
+  /// Find the membership entry for id or the position where it would be inserted
+  inline SubPopT::iterator findSubPop( interventions::ComponentId id ){
+      return std::lower_bound( m_subPopExp.begin(), m_subPopExp.end(), id,
+          []( const SubPopT::value_type& x, interventions::ComponentId y ){ return x.first < y; } );
+  }
+  inline SubPopT::const_iterator findSubPop( interventions::ComponentId id )const{
+      return std::lower_bound( m_subPopExp.begin(), m_subPopExp.end(), id,
+          []( const SubPopT::value_type& x, interventions::ComponentId y ){ return x.first < y; } );
+  }
+  /// Set m_subPopNextExp from m_subPopExp
+  void updateSubPopNextExp();
   
-  //TODO(optimisation): it might be better to instead store for each
-  // ComponentId of interest the set of humans who are members
-  typedef std::map<interventions::ComponentId,SimTime> SubPopT;
   /** This lists sub-populations of which the human is a member together with
    * expiry time.
    * 
@@ -231,8 +330,19 @@ private:
    * NOTE: this discrepancy is because intervention deployment effectively
    * happens at the end of a time step and we want a duration of 1 time step to
    * mean 1 intervention deployment (that where the human becomes a member) and
-   * 1 human update (the next). */
+   * 1 human update (the next).
+   * 
+   * Entries are mirrored in SubPopIndex. */
   SubPopT m_subPopExp;
+  /** Earliest expiry time in m_subPopExp or SimTime::future() if empty (not
+   * checkpointed). This may be earlier than the true value after removals;
+   * it exists so that update() need only walk m_subPopExp when something
+   * may have expired. */
+  SimTime m_subPopNextExp;
+  
+  /** Time step (ts0) of the first update not yet applied when sleeping,
+   * otherwise SimTime::never(). */
+  SimTime m_sleepingSince;
   
   friend class ::UnittestUtil;
 };
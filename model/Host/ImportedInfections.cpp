@@ -23,6 +23,7 @@
 #include "util/random.h"
 #include "util/timeConversions.h"
 #include "Population.h"
+#include "interventions/InterventionManager.hpp"
 
 namespace OM { namespace Host {
 
@@ -85,9 +86,23 @@ void ImportedInfections::import( Population& population ){
     
     double rateNow = rate[lastIndex].value;
     if( rateNow > 0.0 ){
-        for(Human& human : population){
-            if(human.rng().bernoulli( rateNow )){
-                human.addInfection();
+        if( interventions::InterventionManager::fastSampling() ){
+            // Population-level sampling: jump straight to each importing human
+            util::BlockRng& rng = interventions::InterventionManager::deploymentRng();
+            const double p = std::min( rateNow, 1.0 );
+            const uint64_t size = population.size();
+            uint64_t i = rng.geometric_skip( p );
+            while( i < size ){
+                (population.begin() + i)->addInfection();
+                uint64_t skip = rng.geometric_skip( p );
+                if( skip >= size ) break;
+                i += skip + 1;
+            }
+        }else{
+            for(Human& human : population){
+                if(human.rng().bernoulli( rateNow )){
+                    human.addInfection();
+                }
             }
         }
     }
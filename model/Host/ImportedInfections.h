@@ -47,7 +47,9 @@ namespace Host {
          *  from the importedInfectionsPerThousandHosts. The bernoulli distribution
          *  is then used to predict if an human has imported the infection in the
          *  population or not. A maximum of one infection can be imported per
-         *  person.
+         *  person. With the FAST_DEPLOYMENT_SAMPLING model option, importing
+         *  humans are instead selected by geometric skip-ahead using the
+         *  intervention manager's deployment RNG.
          * 
          * @param pop The Population class encapsulating all humans */
         void import( Population& pop );
@@ -0,0 +1,99 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "Host/SubPopIndex.h"
+
+#include <cassert>
+
+namespace OM { namespace Host {
+
+std::vector<SubPopIndex::Members> SubPopIndex::members;
+
+void SubPopIndex::clear(){
+    members.clear();
+}
+
+void SubPopIndex::add( size_t component, uint64_t serial ){
+    if( component >= members.size() ) members.resize( component + 1 );
+    Members& list = members[component];
+    if( list.words.empty() ){
+        list.base = serial & ~uint64_t(63);
+    }else if( serial < list.base ){
+        const uint64_t base = serial & ~uint64_t(63);
+        list.words.insert( list.words.begin(), (list.base - base) / 64, 0 );
+        list.base = base;
+    }
+    const size_t w = (serial - list.base) / 64;
+    if( w >= list.words.size() ) list.words.resize( w + 1, 0 );
+    const uint64_t bit = uint64_t(1) << ((serial - list.base) % 64);
+    if( (list.words[w] & bit) == 0 ){
+        list.words[w] |= bit;
+        list.count += 1;
+    }
+}
+
+void SubPopIndex::remove( size_t component, uint64_t serial ){
+    if( component >= members.size() ) return;
+    Members& list = members[component];
+    if( serial < list.base ) return;
+    const size_t w = (serial - list.base) / 64;
+    if( w >= list.words.size() ) return;
+    const uint64_t bit = uint64_t(1) << ((serial - list.base) % 64);
+    if( (list.words[w] & bit) != 0 ){
+        list.words[w] &= ~bit;
+        list.count -= 1;
+        if( list.count == 0 ) list.words.clear();
+    }
+}
+
+bool SubPopIndex::contains( size_t component, uint64_t serial ){
+    if( component >= members.size() ) return false;
+    const Members& list = members[component];
+    if( serial < list.base ) return false;
+    const size_t w = (serial - list.base) / 64;
+    if( w >= list.words.size() ) return false;
+    return (list.words[w] >> ((serial - list.base) % 64)) & 1;
+}
+
+size_t SubPopIndex::count( size_t component ){
+    if( component >= members.size() ) return 0;
+    return members[component].count;
+}
+
+void SubPopIndex::discardBelow( uint64_t first ){
+    for( Members& list : members ){
+        if( first < list.base + 64 ) continue;
+        size_t n = (first - list.base) / 64;
+        // Drop leading blocks only once they make up half the list, so the
+        // cost is amortised over the steps in which they accumulate.
+        if( 2 * n < list.words.size() ) continue;
+        if( n >= list.words.size() ){
+            assert( list.count == 0 );
+            list.words.clear();
+            list.base = first & ~uint64_t(63);
+            continue;
+        }
+        for( size_t w = 0; w < n; ++w ) assert( list.words[w] == 0 );
+        list.words.erase( list.words.begin(), list.words.begin() + n );
+        list.base += 64 * n;
+    }
+}
+
+} }
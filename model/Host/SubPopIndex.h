@@ -0,0 +1,108 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_SubPopIndex
+#define Hmod_SubPopIndex
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+namespace OM { namespace Host {
+
+/** Population-level index of sub-population membership.
+ *
+ * For each intervention component (by ComponentId::id) this stores the set of
+ * member humans as a bitset over human serial numbers (Human::serial()).
+ * Serial numbers increase in population order, so members are visited in
+ * population order.
+ *
+ * Human keeps the index in step with its own list of memberships: a human is
+ * listed for a component exactly when that list has an entry for it. This
+ * includes memberships which have expired but which the human's next update
+ * has not yet removed, so users should still check Human::isInSubPop(). */
+class SubPopIndex {
+public:
+    /// Remove all members (before loading a population)
+    static void clear();
+
+    /// Add a member (no effect if already listed)
+    static void add( size_t component, uint64_t serial );
+    /// Remove a member (no effect if not listed)
+    static void remove( size_t component, uint64_t serial );
+    /// True if listed
+    static bool contains( size_t component, uint64_t serial );
+    /// Number of listed members
+    static size_t count( size_t component );
+
+    /** Call f(serial) for each member with first <= serial < last, in
+     * increasing order.
+     *
+     * f may add or remove the member it is passed (e.g. when deploying to
+     * it), but not other members. */
+    template<class F>
+    static void forEach( size_t component, uint64_t first, uint64_t last, F f ){
+        if( component >= members.size() ) return;
+        uint64_t base = members[component].base;
+        if( first < base ) first = base;
+        if( first >= last ) return;
+        for( size_t w = (first - base) / 64; ; ++w ){
+            // re-read each block: f may have resized the list
+            const Members& list = members[component];
+            if( w >= list.words.size() ) return;
+            const uint64_t wordBase = base + 64 * w;
+            if( wordBase >= last ) return;
+            uint64_t word = list.words[w];
+            if( first > wordBase ) word &= ~uint64_t(0) << (first - wordBase);
+            while( word != 0 ){
+                const uint64_t serial = wordBase + lowestBit( word );
+                if( serial >= last ) return;
+                f( serial );
+                word &= word - 1;       // clear lowest set bit
+            }
+        }
+    }
+
+    /** Free storage for serial numbers below first, which must have no
+     * members (e.g. the serial of the oldest living human). */
+    static void discardBelow( uint64_t first );
+
+private:
+    static inline unsigned lowestBit( uint64_t word ){
+#if defined(__GNUC__)
+        return __builtin_ctzll( word );
+#else
+        unsigned n = 0;
+        while( (word & 1) == 0 ){ word >>= 1; n += 1; }
+        return n;
+#endif
+    }
+
+    struct Members {
+        Members() : base(0), count(0) {}
+        uint64_t base;          // serial number of the first bit of words[0]; multiple of 64
+        std::vector<uint64_t> words;
+        size_t count;           // number of set bits
+    };
+    static std::vector<Members> members;        // by component
+};
+
+} }
+#endif
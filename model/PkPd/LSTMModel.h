@@ -130,6 +130,12 @@ public:
      * become negligible. */
     void decayDrugs (double body_mass);
     
+    /** True when there are no drugs in the blood and no pending medications,
+     * in which case medicate() and decayDrugs() do nothing. */
+    inline bool empty() const{
+        return m_drugs.empty() && medicateQueue.empty();
+    }
+    
     /** Make summaries of drug concentration data. */
     void summarize( const Host::Human& human ) const;
     
@@ -20,22 +20,26 @@
 
 #include "Population.h"
 #include "mon/Continuous.h"
+#include "mon/reporting.h"
 
 #include "Host/Human.h"
 #include "Host/NeonatalMortality.h"
 #include "WithinHost/WHInterface.h"
 #include "WithinHost/Genotypes.h"
 #include "WithinHost/Diagnostic.h"
+#include "WithinHost/Infection/DescriptiveBatch.h"
 #include "Clinical/ClinicalModel.h"
 #include "Transmission/TransmissionModel.h"
 
 #include "util/errors.h"
 #include "util/random.h"
 #include "util/ModelOptions.h"
+#include "util/CommandLine.h"
 #include "util/StreamValidator.h"
 #include <schema/scenario.h>
 
 #include <cmath>
+#include <algorithm>
 #include <boost/format.hpp>
 #include <boost/assign.hpp>
 
@@ -47,12 +51,16 @@ namespace OM
 
 // -----  Population: static data / methods  -----
 
+/// True when using LAZY_QUIESCENT_HUMANS
+bool lazyQuiescentHumans = false;
+
 void Population::init( const Parameters& parameters, const scnXml::Scenario& scenario )
 {
     Host::Human::init( parameters, scenario );
     Host::NeonatalMortality::init( scenario.getModel().getClinical() );
     
     AgeStructure::init( scenario.getDemography() );
+    lazyQuiescentHumans = ModelOptions::option( LAZY_QUIESCENT_HUMANS );
 }
 
 void Population::staticCheckpoint (istream& stream)
@@ -74,7 +82,8 @@ void Population::staticCheckpoint (ostream& stream)
 // -----  non-static methods: creation/destruction, checkpointing  -----
 
 Population::Population(size_t populationSize)
-    : populationSize (populationSize), recentBirths(0)
+    : populationSize (populationSize), recentBirths(0),
+    ctsStatsTime(SimTime::never())
 {
     using mon::Continuous;
     Continuous.registerCallback( "hosts", "\thosts", MakeDelegate( this, &Population::ctsHosts ) );
@@ -114,14 +123,19 @@ Population::Population(size_t populationSize)
 
 void Population::checkpoint (istream& stream)
 {
-    populationSize & stream;
+    size_t storedSize;
+    storedSize & stream;
+    // populationSize is set by the scenario; a mismatch means a bad checkpoint
+    if( storedSize != populationSize )
+        throw util::checkpoint_error(
+            (boost::format("Population: size %1% does not match scenario") %storedSize ).str() );
     recentBirths & stream;
     
+    population.clear();
+    Host::Human::resetIndex();  // humans are renumbered in order as loaded
+    population.reserve( populationSize );
     for(size_t i = 0; i < populationSize && !stream.eof(); ++i) {
-        // Note: calling this constructor of Host::Human is slightly wasteful, but avoids the need for another
-        // ctor and leaves less opportunity for uninitialized memory.
-        population.push_back( Host::Human (SimTime::zero()) );
-        population.back() & stream;
+        population.emplace_back( stream );
     }
     if (population.size() != populationSize)
         throw util::checkpoint_error(
@@ -129,6 +143,7 @@ void Population::checkpoint (istream& stream)
 }
 void Population::checkpoint (ostream& stream)
 {
+    catchUpAll();       // skipped updates are not checkpointed
     populationSize & stream;
     recentBirths & stream;
     
@@ -144,6 +159,24 @@ void Population::preMainSimInit ()
     recentBirths = 0;
 }
 
+std::pair<Population::Iter, Population::Iter> Population::birthCohort( SimTime dob ){
+    Iter first = std::lower_bound( population.begin(), population.end(), dob,
+        []( const Host::Human& human, SimTime date ){ return human.getDateOfBirth() < date; } );
+    Iter last = std::upper_bound( first, population.end(), dob,
+        []( SimTime date, const Host::Human& human ){ return date < human.getDateOfBirth(); } );
+    return std::make_pair( first, last );
+}
+
+std::pair<Population::Iter, Population::Iter> Population::ageRange( SimTime minAge, SimTime maxAge ){
+    // age >= minAge and age < maxAge iff now - maxAge < dob <= now - minAge
+    auto dobLess = []( SimTime date, const Host::Human& human ){ return date < human.getDateOfBirth(); };
+    Iter first = std::upper_bound( population.begin(), population.end(),
+        sim::now() - maxAge, dobLess );
+    Iter last = std::upper_bound( first, population.end(),
+        sim::now() - minAge, dobLess );
+    return std::make_pair( first, last );
+}
+
 void Population::createInitialHumans()
 {
     /* We create a whole population here, regardless of whether humans can
@@ -179,16 +212,51 @@ void Population::update( const Transmission::TransmissionModel& transmission, Si
     // (until humans old enough to be pregnate get updated and can be infected).
     Host::NeonatalMortality::update (*this);
     
-    // Update each human in turn
+    // Quiescent humans may only sleep through steps with zero EIR
+    const bool lazy = lazyQuiescentHumans && transmission.eirIsZero();
+    
+    // With BATCHED_DESCRIPTIVE_UPDATE, humans are updated in two passes
+    // with a population-wide density update between; this lists humans
+    // to finish, with their position.
+    const bool batched = WithinHost::DescriptiveBatch::enabled();
+    vector<pair<size_t, Host::Human*>> started;
+    if( batched ) WithinHost::DescriptiveBatch::clear();
+    
+    // Update each human in turn, accumulating reports by population chunk
+    const size_t popSize = population.size();
+    size_t i = 0;
     for (Host::Human& human : population) {
+        const size_t pos = i++;
+        mon::setReportChunk( mon::reportChunk( pos, popSize ) );
         // Update human, and remove if too old.
         // We only need to update humans who will survive past the end of the
         // "one life span" init phase (this is an optimisation). lastPossibleTS
         // is the time step they die at (some code still runs on this step).
         SimTime lastPossibleTS = human.getDateOfBirth() + sim::maxHumanAge();   // this is last time of possible update
-        if (lastPossibleTS >= firstVecInitTS)
-            human.update(transmission);
+        if (lastPossibleTS >= firstVecInitTS){
+            if( human.isSleeping() ){
+                if( lazy && human.updateSleeping(transmission) ) continue;
+                human.wake();
+            }
+            if( batched ){
+                if( human.updateStart(transmission) )
+                    started.push_back( make_pair( pos, &human ) );
+            }else{
+                human.update(transmission);
+                if( lazy && human.isQuiescent() ) human.sleep();
+            }
+        }
     }
+    if( batched ){
+        WithinHost::DescriptiveBatch::sweep();
+        for( auto& entry : started ){
+            mon::setReportChunk( mon::reportChunk( entry.first, popSize ) );
+            Host::Human& human = *entry.second;
+            human.updateFinish();
+            if( lazy && human.isQuiescent() ) human.sleep();
+        }
+    }
+    mon::setReportChunk( mon::NO_REPORT_CHUNK );
     
     //NOTE: other parts of code are not set up to handle changing population size. Also
     // populationSize is assumed to be the _actual and exact_ population size by other code.
@@ -206,6 +274,7 @@ void Population::update( const Transmission::TransmissionModel& transmission, Si
         bool outmigrate = cumPop >= AgeStructure::targetCumPop(iter->age(sim::ts1()).inSteps(), targetPop);
         
         if( isDead || outmigrate ){
+            iter->removeFromIndex();
             iter = population.erase (iter);
             continue;
         }
@@ -213,6 +282,9 @@ void Population::update( const Transmission::TransmissionModel& transmission, Si
         ++iter;
     } // end of per-human updates
 
+    if( !population.empty() )
+        Host::SubPopIndex::discardBelow( population.front().serial() );
+
     // increase population size to targetPop
     recentBirths += (targetPop - cumPop);
     while (cumPop < targetPop) {
@@ -244,80 +316,97 @@ void Population::ctsRecentBirths (ostream& stream){
     stream << '\t' << recentBirths;
     recentBirths = 0;
 }
-void Population::ctsPatentHosts (ostream& stream){
-    int patent = 0;
+const Population::CtsStats& Population::ctsStats (){
+    if( ctsStatsTime == sim::now() ) return ctsStatsCache;
+    ctsStatsTime = sim::now();
+    catchUpAll();
+    
+    using mon::Continuous;
+    const bool patent = Continuous.isEnabled( "patent hosts" );
+    const bool immH = Continuous.isEnabled( "immunity h" );
+    const bool immY = Continuous.isEnabled( "immunity Y" );
+    const bool medY = Continuous.isEnabled( "median immunity Y" );
+    const bool avail = Continuous.isEnabled( "human age availability" );
+    const bool itn = Continuous.isEnabled( "ITN coverage" );
+    const bool irs = Continuous.isEnabled( "IRS coverage" );
+    const bool gvi = Continuous.isEnabled( "GVI coverage" );
+    
+    CtsStats& stats = ctsStatsCache;
+    stats.patent = 0;
+    stats.sumh = 0.0;
+    stats.sumY = 0.0;
+    stats.listY.clear();
+    if( medY ) stats.listY.reserve( populationSize );
+    stats.nAvail = 0;
+    stats.sumAvail = 0.0;
+    stats.nITN = stats.nIRS = stats.nGVI = 0;
+    
+    const auto& diag = WithinHost::diagnostics::monitoringDiagnostic();
     for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        auto diag = WithinHost::diagnostics::monitoringDiagnostic();
-        if( iter->getWithinHostModel().diagnosticResult(iter->rng(), diag) )
-            ++patent;
+        const WithinHost::WHInterface& whm = iter->getWithinHostModel();
+        if( patent && whm.diagnosticResult(iter->rng(), diag) )
+            ++stats.patent;
+        if( immH ) stats.sumh += whm.getCumulative_h();
+        if( immY || medY ){
+            double Y = whm.getCumulative_Y();
+            stats.sumY += Y;
+            if( medY ) stats.listY.push_back( Y );
+        }
+        const Transmission::PerHost& pht = iter->perHostTransmission;
+        if( avail && !pht.isOutsideTransmission() ){
+            ++stats.nAvail;
+            stats.sumAvail += pht.relativeAvailabilityAge(iter->age(sim::now()).inYears());
+        }
+        if( itn ) stats.nITN += pht.hasActiveInterv( interventions::Component::ITN );
+        if( irs ) stats.nIRS += pht.hasActiveInterv( interventions::Component::IRS );
+        if( gvi ) stats.nGVI += pht.hasActiveInterv( interventions::Component::GVI );
     }
-    stream << '\t' << patent;
+    return stats;
+}
+
+void Population::ctsPatentHosts (ostream& stream){
+    stream << '\t' << ctsStats().patent;
 }
 void Population::ctsImmunityh (ostream& stream){
-    double x = 0.0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        x += iter->getWithinHostModel().getCumulative_h();
-    }
+    double x = ctsStats().sumh;
     x /= populationSize;
     stream << '\t' << x;
 }
 void Population::ctsImmunityY (ostream& stream){
-    double x = 0.0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        x += iter->getWithinHostModel().getCumulative_Y();
-    }
+    double x = ctsStats().sumY;
     x /= populationSize;
     stream << '\t' << x;
 }
 void Population::ctsMedianImmunityY (ostream& stream){
-    vector<double> list;
-    list.reserve( populationSize );
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        list.push_back( iter->getWithinHostModel().getCumulative_Y() );
-    }
-    sort( list.begin(), list.end() );
+    // we only need the middle element(s), not a full sort
+    ctsStats();
+    vector<double>& list = ctsStatsCache.listY;
     double x;
+    size_t i = populationSize / 2;
+    nth_element( list.begin(), list.begin() + i, list.end() );
     if( mod_nn(populationSize, 2) == 0 ){
-        size_t i = populationSize / 2;
-        x = (list[i-1]+list[i])/2.0;
+        // list[i-1] of a sorted list is the largest element before i
+        double lower = *max_element( list.begin(), list.begin() + i );
+        x = (lower+list[i])/2.0;
     }else{
-        x = list[populationSize / 2];
+        x = list[i];
     }
     stream << '\t' << x;
 }
 void Population::ctsMeanAgeAvailEffect (ostream& stream){
-    int nHumans = 0;
-    double avail = 0.0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        if( !iter->perHostTransmission.isOutsideTransmission() ){
-            ++nHumans;
-            avail += iter->perHostTransmission.relativeAvailabilityAge(iter->age(sim::now()).inYears());
-        }
-    }
-    stream << '\t' << avail/nHumans;
+    const CtsStats& stats = ctsStats();
+    stream << '\t' << stats.sumAvail/stats.nAvail;
 }
 void Population::ctsITNCoverage (ostream& stream){
-    int nActive = 0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::ITN );
-    }
-    double coverage = static_cast<double>(nActive) / populationSize;
+    double coverage = static_cast<double>(ctsStats().nITN) / populationSize;
     stream << '\t' << coverage;
 }
 void Population::ctsIRSCoverage (ostream& stream){
-    int nActive = 0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::IRS );
-    }
-    double coverage = static_cast<double>(nActive) / populationSize;
+    double coverage = static_cast<double>(ctsStats().nIRS) / populationSize;
     stream << '\t' << coverage;
 }
 void Population::ctsGVICoverage (ostream& stream){
-    int nActive = 0;
-    for(Iter iter = population.begin(); iter != population.end(); ++iter) {
-        nActive += iter->perHostTransmission.hasActiveInterv( interventions::Component::GVI );
-    }
-    double coverage = static_cast<double>(nActive) / populationSize;
+    double coverage = static_cast<double>(ctsStats().nGVI) / populationSize;
     stream << '\t' << coverage;
 }
 // void Population::ctsNetHoleIndex (ostream& stream){
@@ -334,15 +423,34 @@ void Population::ctsGVICoverage (ostream& stream){
 
 void Population::newSurvey ()
 {
+    catchUpAll();
+    // When streaming output, surveys are written once no more reports can
+    // arrive for them; flushing expired episodes now makes this sooner.
+    const bool flushExpired = util::CommandLine::option( util::CommandLine::STREAM_OUTPUT );
+    const size_t popSize = population.size();
+    size_t i = 0;
     for(Iter iter = population.begin(); iter != population.end(); ++iter) {
+        mon::setReportChunk( mon::reportChunk( i++, popSize ) );
+        if( flushExpired ) iter->flushExpiredReports();
         iter->summarize();
     }
+    mon::setReportChunk( mon::NO_REPORT_CHUNK );
+}
+
+void Population::catchUpAll (){
+    if( !lazyQuiescentHumans ) return;
+    for(Iter iter = population.begin(); iter != population.end(); ++iter)
+        iter->catchUp();
 }
 
 void Population::flushReports (){
+    const size_t popSize = population.size();
+    size_t i = 0;
     for(Iter iter = population.begin(); iter != population.end(); ++iter) {
+        mon::setReportChunk( mon::reportChunk( i++, popSize ) );
         iter->flushReports();
     }
+    mon::setReportChunk( mon::NO_REPORT_CHUNK );
 }    
 
 }
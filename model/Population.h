@@ -28,6 +28,7 @@
 #include <vector>
 #include <fstream>
 #include <utility>  // pair
+#include <algorithm>  // lower_bound
 
 namespace scnXml{
     class Scenario;
@@ -68,6 +69,11 @@ public:
     //! Makes a survey
     void newSurvey();
     
+    /** Catch up all sleeping humans (LAZY_QUIESCENT_HUMANS); required before
+     * anything reads the state of humans other than via their own update.
+     * Humans stay asleep. */
+    void catchUpAll();
+    
     /// Flush anything pending report. Should only be called just before destruction.
     void flushReports();
     
@@ -97,6 +103,45 @@ public:
     inline std::pair<ConstIter, ConstIter> crange() const {
         return std::make_pair(population.cbegin(), population.cend());
     }
+    /** Return the range of humans born at the given date (a birth cohort).
+     * 
+     * Humans are stored in order of date of birth (oldest first; births are
+     * appended), so this is a binary search. */
+    std::pair<Iter, Iter> birthCohort( SimTime dob );
+    /** Return the range of humans whose age now (sim::now()) is at least
+     * minAge and less than maxAge. Like birthCohort(), a binary search. */
+    std::pair<Iter, Iter> ageRange( SimTime minAge, SimTime maxAge );
+    /** Call f(human) for each human in range (a sub-range of the population,
+     * e.g. from ageRange()) listed in Host::SubPopIndex under id, in
+     * population order. Cost is proportional to the number of members.
+     * 
+     * Listed humans include those whose membership expired but has not yet
+     * been removed, so callers should check Human::isInSubPop(). */
+    template<class F>
+    void forEachListedMember( interventions::ComponentId id,
+                              std::pair<Iter, Iter> range, F f )
+    {
+        if( range.first == range.second ) return;
+        Iter it = range.first;
+        const Iter end = range.second;
+        Host::SubPopIndex::forEach( id.id, range.first->serial(),
+                                    (end - 1)->serial() + 1, [&]( uint64_t serial ){
+            // Population is ordered by serial; search forward from the last
+            // member with exponentially growing steps.
+            if( it->serial() < serial ){
+                size_t step = 1;
+                while( static_cast<size_t>(end - it) > step && (it + step)->serial() < serial ){
+                    it += step;
+                    step *= 2;
+                }
+                Iter last = static_cast<size_t>(end - it) > step ? it + step + 1 : end;
+                it = std::lower_bound( it + 1, last, serial,
+                    []( const Host::Human& human, uint64_t s ){ return human.serial() < s; } );
+            }
+            assert( it != end && it->serial() == serial );
+            f( *it );
+        } );
+    }
     /** Return the number of humans. */
     inline size_t size() const {
         return populationSize;
@@ -123,6 +168,19 @@ private:
     void ctsITNCoverage (ostream& stream);
     void ctsIRSCoverage (ostream& stream);
     void ctsGVICoverage (ostream& stream);
+    
+    /** Statistics over the population for continuous reporting. These are
+     * gathered in one pass over the population for all enabled outputs the
+     * first time any is needed during a reporting step. */
+    struct CtsStats {
+        int patent;     // number of patent hosts
+        double sumh, sumY;      // sums of cumulative h and Y
+        vector<double> listY;   // cumulative Y values (for the median)
+        int nAvail;     // humans not outside transmission
+        double sumAvail;        // sum of their age-based availability
+        int nITN, nIRS, nGVI;   // numbers with active interventions
+    };
+    const CtsStats& ctsStats ();
     /// Delegate to print the mean hole index of all bed nets
 //     void ctsNetHoleIndex (ostream& stream);
     
@@ -136,6 +194,9 @@ private:
     
     /// Births since last continuous output
     int recentBirths;
+    
+    CtsStats ctsStatsCache;
+    SimTime ctsStatsTime;       // time ctsStatsCache was gathered (not checkpointed)
     //@}
     
     /** The simulated human population
@@ -37,10 +37,10 @@
 #include "util/errors.h"
 #include "util/random.h"
 #include "util/StreamValidator.h"
+#include "util/timeConversions.h"
 #include "schema/scenario.h"
 
 #include <fstream>
-#include <gzstream/gzstream.h>
 #include <boost/format.hpp>
 
 
@@ -82,7 +82,10 @@ enum Phase {
 // ———  Set-up & tear-down  ———
 
 Simulator::Simulator( const scnXml::Scenario& scenario ) :
-    phase(STARTING_PHASE)
+    phase(STARTING_PHASE),
+    m_checkpointInterval(SimTime::zero()),
+    m_checkpointWalltime(util::CommandLine::getCheckpointWalltime()),
+    m_lastCheckpoint(SimTime::never())
 {
     // ———  Initialise static data  ———
     
@@ -90,6 +93,27 @@ Simulator::Simulator( const scnXml::Scenario& scenario ) :
     
     // 1) elements with no dependencies on other elements initialised here:
     sim::init( scenario );  // also reads survey dates
+    
+    if( !util::CommandLine::getCheckpointInterval().empty() ){
+        // needs the time step, from sim::init
+        try{
+            m_checkpointInterval = UnitParse::readDuration(
+                util::CommandLine::getCheckpointInterval(), UnitParse::STEPS );
+        }catch( const util::format_error& e ){
+            throw util::cmd_exception( string("--checkpoint-interval: ") + e.what() );
+        }
+        if( m_checkpointInterval < SimTime::oneTS() )
+            throw util::cmd_exception( "--checkpoint-interval: must be at least one time step" );
+        // readDuration rounds to whole steps; don't silently change the interval
+        double days = UnitParse::durationToDays(
+            util::CommandLine::getCheckpointInterval(), UnitParse::STEPS );
+        if( days != m_checkpointInterval.inDays() ){
+            ostringstream msg;
+            msg << "--checkpoint-interval: must be a whole number of time steps (nearest: "
+                << m_checkpointInterval.inDays() << "d)";
+            throw util::cmd_exception( msg.str() );
+        }
+    }
     Parameters parameters( model.getParameters() );     // depends on nothing
     WithinHost::Genotypes::init( scenario );
     
@@ -175,11 +199,16 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
     }
     
     int lastPercent = -1;	// last _integer_ percentage value
+    m_lastCheckpointWall = std::chrono::steady_clock::now();
     
     // phase loop
     while (true){
         // loop for steps within a phase
         while (sim::now() < m_phaseEnd){
+            if( phase == MAIN_PHASE && periodicCheckpointDue() ){
+                writeCheckpoint();
+            }
+            
             int percent = (sim::now() * 100) / m_estimatedEnd;
             if( percent != lastPercent ){	// avoid huge amounts of output for performance/log-file size reasons
                 lastPercent = percent;
@@ -251,15 +280,19 @@ void Simulator::start(const scnXml::Monitoring& monitoring){
         if (phase == MAIN_PHASE && util::CommandLine::option (util::CommandLine::CHECKPOINT)){
             writeCheckpoint();
             if( util::CommandLine::option (util::CommandLine::CHECKPOINT_STOP) ){
+                finishCheckpoint();
                 throw util::cmd_exception ("Checkpoint test: checkpoint written", util::Error::None);
             }
         }
     }
     
     cerr << '\r' << flush;	// clean last line of progress-output
+    finishCheckpoint();
     
     population->flushReports();        // ensure all Human instances report past events
     mon::writeSurveyData();
+    Continuous.flush();
+    Continuous.finishWrite();
     
 # ifdef OM_STREAM_VALIDATOR
     util::StreamValidator.saveStream();
@@ -280,24 +313,14 @@ int readCheckpointNum () {
     return checkpointNum;
 }
 
-void Simulator::writeCheckpoint(){
-    // We alternate between two checkpoints, in case program is closed while writing.
-    const int NUM_CHECKPOINTS = 2;
-    
-    int oldCheckpointNum = 0, checkpointNum = 0;
-    if (isCheckpoint()) {
-        oldCheckpointNum = readCheckpointNum();
-        // Get next checkpoint number:
-        checkpointNum = mod_nn(oldCheckpointNum + 1, NUM_CHECKPOINTS);
-    }
-    
-    {   // Open the next checkpoint file for writing:
+/* Write the serialised checkpoint data to file number checkpointNum, then
+ * point the "checkpoint" file at it and truncate the old one. May be called
+ * from a background thread: uses no simulation state. */
+void writeCheckpointFiles (const string& data, int checkpointNum, int oldCheckpointNum){
+    {   // Compress and write the checkpoint file:
         ostringstream name;
         name << CHECKPOINT << checkpointNum << ".gz";
-        //Writing checkpoint:
-        ogzstream out(name.str().c_str(), ios::out | ios::binary);
-        checkpoint (out);
-        out.close();
+        util::checkpoint::writeFile (data, name.str());
     }
     
     {   // Indicate which is the latest checkpoint file.
@@ -315,7 +338,78 @@ void Simulator::writeCheckpoint(){
         ofstream out(name.str().c_str(), ios::out | ios::binary);
         out.close();
     }
-//     cerr << " OK" << endl;
+}
+
+void Simulator::writeCheckpoint(){
+    // We alternate between two checkpoints, in case program is closed while writing.
+    const int NUM_CHECKPOINTS = 2;
+    
+    // The previous write must complete first: it updates the "checkpoint" file
+    finishCheckpoint();
+    
+    // With periodic checkpoints we may have written one during this run
+    int oldCheckpointNum = 0, checkpointNum = 0;
+    if (ifstream(CHECKPOINT).is_open()) {
+        oldCheckpointNum = readCheckpointNum();
+        // Get next checkpoint number:
+        checkpointNum = mod_nn(oldCheckpointNum + 1, NUM_CHECKPOINTS);
+    }
+    
+    m_lastCheckpoint = sim::now();
+    m_lastCheckpointWall = std::chrono::steady_clock::now();
+    
+    // Serialise into memory (quick); compression and writing take longer.
+    ostringstream out(ios::out | ios::binary);
+    checkpoint (out);
+    
+    if( util::CommandLine::option (util::CommandLine::CHECKPOINT_ASYNC) ){
+        // Simulation data is not touched by the writer, so we can continue.
+        // Note: the string is moved into the thread's copy of its arguments.
+        checkpointWriter = std::thread( [this] (const string& data, int num, int oldNum) {
+                try {
+                    writeCheckpointFiles (data, num, oldNum);
+                } catch (...) {
+                    checkpointWriterError = std::current_exception();
+                }
+            }, out.str(), checkpointNum, oldCheckpointNum );
+    } else {
+        writeCheckpointFiles (out.str(), checkpointNum, oldCheckpointNum);
+    }
+}
+
+bool Simulator::periodicCheckpointDue() const{
+    // Never twice at the same time, in particular not straight after
+    // resuming from a checkpoint or the one at the start of the main phase.
+    if( sim::now() == m_lastCheckpoint ) return false;
+    
+    if( m_checkpointInterval > SimTime::zero() && sim::intervTime() > SimTime::zero()
+        && sim::intervTime().inSteps() % m_checkpointInterval.inSteps() == 0 )
+        return true;
+    
+    if( m_checkpointWalltime > 0.0 ){
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - m_lastCheckpointWall;
+        if( elapsed.count() >= m_checkpointWalltime )
+            return true;
+    }
+    return false;
+}
+
+void Simulator::finishCheckpoint(){
+    if( checkpointWriter.joinable() )
+        checkpointWriter.join();
+    if( checkpointWriterError ){
+        std::exception_ptr e = checkpointWriterError;
+        checkpointWriterError = nullptr;
+        std::rethrow_exception( e );
+    }
+}
+
+Simulator::~Simulator(){
+    // Only reached with a write pending if an exception is being handled;
+    // don't throw another.
+    if( checkpointWriter.joinable() )
+        checkpointWriter.join();
 }
 
 void Simulator::readCheckpoint() {
@@ -324,13 +418,13 @@ void Simulator::readCheckpoint() {
     // Open the latest file
     ostringstream name;
     name << CHECKPOINT << checkpointNum << ".gz";
-    igzstream in(name.str().c_str(), ios::in | ios::binary);
-    //Note: gzstreams are considered "good" when file not open!
-    if ( !( in.good() && in.rdbuf()->is_open() ) )
-        throw util::checkpoint_error ("Unable to read file");
+    string data;
+    util::checkpoint::readFile (name.str(), data);
+    util::checkpoint::MemoryBuf buf (&data[0], &data[0] + data.size());
+    istream in (&buf);
     checkpoint (in);
-    in.close();
-  
+    m_lastCheckpoint = sim::now();
+    
     cerr << sim::now().inSteps() << "t loaded checkpoint" << endl;
 }
 
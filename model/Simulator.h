@@ -24,6 +24,9 @@
 #include "Global.h"
 #include "Population.h"
 #include "Transmission/TransmissionModel.h"
+#include <thread>
+#include <chrono>
+#include <exception>
 using namespace std;
 
 namespace scnXml{
@@ -37,6 +40,8 @@ class Simulator{
 public: 
     //!  Inititalise all step specific constants and variables.
     Simulator( const scnXml::Scenario& scenario );
+    /// Waits for any checkpoint still being written
+    ~Simulator();
     
     //! Entry point to simulation.
     void start(const scnXml::Monitoring& monitoring);
@@ -52,6 +57,12 @@ private:
     //@{
     void writeCheckpoint();
     void readCheckpoint();
+    /** Wait for a checkpoint being written in the background (if any) and
+     * throw if writing it failed. */
+    void finishCheckpoint();
+    /** True when a periodic checkpoint (--checkpoint-interval or
+     * --checkpoint-walltime) is due at the current step boundary. */
+    bool periodicCheckpointDue() const;
     
     void checkpoint (istream& stream);
     void checkpoint (ostream& stream);
@@ -62,6 +73,16 @@ private:
     SimTime m_estimatedEnd;
     int phase;  // only need be a class member because value is checkpointed
     
+    // Periodic checkpoints (not checkpointed: taken from the command line)
+    SimTime m_checkpointInterval;       // zero when disabled
+    double m_checkpointWalltime;        // seconds; zero when disabled
+    SimTime m_lastCheckpoint;   // time of last write or of resuming
+    std::chrono::steady_clock::time_point m_lastCheckpointWall;
+    
+    // Background writer when using --checkpoint-async, and its error (if any)
+    std::thread checkpointWriter;
+    std::exception_ptr checkpointWriterError;
+    
     static bool startedFromCheckpoint;
     
     friend class AnophelesModelSuite;
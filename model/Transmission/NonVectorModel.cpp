@@ -212,6 +212,19 @@ void NonVectorModel::update (const Population& population) {
 }
 
 
+bool NonVectorModel::eirIsZero() const{
+    // As calculateEIR() before the per-host availability factor
+    if (simulationMode == transientEIRknown)
+        return interventionEIR[sim::intervTime().inSteps()] == 0.0;
+    if (initialisationEIR[sim::ts0().moduloYearSteps()] == 0.0)
+        return true;
+    if (simulationMode == dynamicEIR && sim::intervTime() >= SimTime::zero()) {
+        size_t t = (sim::ts1()-nSpore).inSteps();
+        return laggedKappa[mod_nn(t, laggedKappa.size())] == 0.0;
+    }
+    return false;
+}
+
 void NonVectorModel::calculateEIR(Host::Human& human, double ageYears, vector<double>& EIR) const{
     EIR.resize( 1 );    // no support for per-genotype tracking in this model (possible, but we're lazy)
     // where the full model, with estimates of human mosquito transmission is in use, use this:
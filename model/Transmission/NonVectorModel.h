@@ -71,6 +71,7 @@ public:
   
   virtual void vectorUpdate (const Population& population) {}
   virtual void update (const Population& population);
+  virtual bool eirIsZero() const;
   virtual void calculateEIR(OM::Host::Human& human, double ageYears, vector< double >& EIR) const;
   
 private:
@@ -206,6 +206,10 @@ double TransmissionModel::getEIR( Host::Human& human, SimTime age,
     return allEIR;
 }
 
+void TransmissionModel::countZeroEIRHost (SimTime age) const{
+    if( age >= adultAge ) tsNumAdults += 1;
+}
+
 void TransmissionModel::summarize () {
     mon::reportStatMF( mon::MVF_NUM_TRANSMIT, laggedKappa[sim::now().moduloSteps(laggedKappa.size())] );
     mon::reportStatMF( mon::MVF_ANN_AVG_K, _annualAverageKappa );
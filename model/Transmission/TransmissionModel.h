@@ -184,6 +184,16 @@ public:
   double getEIR (Host::Human& human, SimTime age, double ageYears,
                  vector<double>& EIR) const;
   
+  /** True if every human is exposed to zero EIR during this time step.
+   * 
+   * Conservative: may return false when the EIR is in fact zero. Only valid
+   * during human updates (after vectorUpdate()). */
+  virtual bool eirIsZero() const =0;
+  
+  /** Account for a human whose update is skipped this step while eirIsZero()
+   * (as getEIR() would, with an EIR of zero). */
+  void countZeroEIRHost (SimTime age) const;
+  
   /** Deploy a vector population intervention.
    *
    * Instance: the index of this instance of the intervention. Each instance
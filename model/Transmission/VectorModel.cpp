@@ -77,31 +77,45 @@ void VectorModel::ctsCbS_v (ostream& stream) {
     for(size_t i = 0; i < speciesIndex.size(); ++i)
         stream << '\t' << species[i].getLastVecStat(Anopheles::SV);
 }
+void VectorModel::ctsGatherHumanSums (const Population& population){
+    if( ctsHumanSumsTime == sim::now() ) return;
+    ctsHumanSumsTime = sim::now();
+    
+    using mon::Continuous;
+    const bool alpha = Continuous.isEnabled( "alpha" );
+    const bool pB = Continuous.isEnabled( "P_B" );
+    const bool pCD = Continuous.isEnabled( "P_C*P_D" );
+    const size_t nSpecies = speciesIndex.size();
+    ctsSumAlpha.assign( alpha ? nSpecies : 0, 0.0 );
+    ctsSumP_B.assign( pB ? nSpecies : 0, 0.0 );
+    ctsSumP_CD.assign( pCD ? nSpecies : 0, 0.0 );
+    
+    for(Population::ConstIter iter = population.cbegin(); iter != population.cend(); ++iter) {
+        const PerHost& pht = iter->perHostTransmission;
+        const double ageYears = iter->age(sim::now()).inYears();
+        for( size_t i = 0; i < nSpecies; ++i){
+            if( alpha ) ctsSumAlpha[i] += pht.entoAvailabilityFull( i, ageYears );
+            if( pB ) ctsSumP_B[i] += pht.probMosqBiting( i );
+            if( pCD ) ctsSumP_CD[i] += pht.probMosqResting( i );
+        }
+    }
+}
 void VectorModel::ctsCbAlpha (const Population& population, ostream& stream){
+    ctsGatherHumanSums( population );
     for( size_t i = 0; i < speciesIndex.size(); ++i){
-        double total = 0.0;
-        for(Population::ConstIter iter = population.cbegin(); iter != population.cend(); ++iter) {
-            total += iter->perHostTransmission.entoAvailabilityFull( i, iter->age(sim::now()).inYears() );
-        }
-        stream << '\t' << total / population.size();
+        stream << '\t' << ctsSumAlpha[i] / population.size();
     }
 }
 void VectorModel::ctsCbP_B (const Population& population, ostream& stream){
+    ctsGatherHumanSums( population );
     for( size_t i = 0; i < speciesIndex.size(); ++i){
-        double total = 0.0;
-        for(Population::ConstIter iter = population.cbegin(); iter != population.cend(); ++iter) {
-            total += iter->perHostTransmission.probMosqBiting( i );
-        }
-        stream << '\t' << total / population.size();
+        stream << '\t' << ctsSumP_B[i] / population.size();
     }
 }
 void VectorModel::ctsCbP_CD (const Population& population, ostream& stream){
+    ctsGatherHumanSums( population );
     for( size_t i = 0; i < speciesIndex.size(); ++i){
-        double total = 0.0;
-        for(Population::ConstIter iter = population.cbegin(); iter != population.cend(); ++iter) {
-            total += iter->perHostTransmission.probMosqResting( i );
-        }
-        stream << '\t' << total / population.size();
+        stream << '\t' << ctsSumP_CD[i] / population.size();
     }
 }
 void VectorModel::ctsNetInsecticideContent (const Population& population, ostream& stream){
@@ -160,7 +174,8 @@ VectorModel::VectorModel (
                           const scnXml::Entomology& entoData,
                           const scnXml::Vector vectorData, int populationSize) :
     TransmissionModel( entoData, WithinHost::Genotypes::N() ),
-    m_rng(util::master_RNG), initIterations(0)
+    m_rng(util::master_RNG), initIterations(0),
+    ctsHumanSumsTime(SimTime::never())
 {
     // Each item in the AnophelesSequence represents an anopheles species.
     // TransmissionModel::createTransmissionModel checks length of list >= 1.
@@ -426,6 +441,17 @@ SimTime VectorModel::initIterate () {
     }
 }
 
+bool VectorModel::eirIsZero() const{
+    if (simulationMode == forcedEIR)
+        return initialisationEIR[sim::ts0().moduloYearSteps()] == 0.0;
+    for(size_t i = 0; i < speciesIndex.size(); ++i) {
+        for( double eir : species[i].getPartialEIR() ){
+            if( eir != 0.0 ) return false;
+        }
+    }
+    return true;
+}
+
 void VectorModel::calculateEIR(Host::Human& human, double ageYears,
         vector<double>& EIR) const
 {
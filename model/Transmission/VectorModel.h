@@ -65,6 +65,7 @@ public:
   virtual void vectorUpdate (const Population& population);
   virtual void update (const Population& population);
 
+  virtual bool eirIsZero() const;
   virtual void calculateEIR( Host::Human& human, double ageYears,
         vector<double>& EIR ) const;
   
@@ -95,6 +96,13 @@ private:
   void ctsCbResAvailability (ostream& stream);
   void ctsCbResRequirements (ostream& stream);
   
+  /** Gather per-species sums over the population of availability (alpha),
+   * P_B and P_C*P_D, for those which are enabled, in one pass. Done the
+   * first time any is needed during a reporting step. */
+  void ctsGatherHumanSums (const Population& population);
+  SimTime ctsHumanSumsTime;     // not checkpointed
+  vector<double> ctsSumAlpha, ctsSumP_B, ctsSumP_CD;
+  
     /// RNG used by the transmission model
     LocalRng m_rng;
   
@@ -143,6 +143,25 @@ void CommonWithinHost::update(LocalRng& rng,
     // Note: adding infections at the beginning of the update instead of the end
     // shouldn't be significant since before latentp delay nothing is updated.
     nNewInfs=min(nNewInfs,MAX_INFECTIONS-numInfs);
+    
+    // Fast path for quiescent hosts (no infections and no drugs): the daily
+    // loop below would have no effect, so only immunity decays.
+    if( nNewInfs == 0 && infections.empty() && pkpdModel.empty() ){
+        updateImmuneStatus ();
+        totalDensity = 0.0;
+        hrp2Density = 0.0;
+        timeStepMaxDensity = 0.0;
+        util::streamValidate(totalDensity);
+        util::streamValidate(hrp2Density);
+        // The lag row need only be reset if it may be non-zero
+        if( m_yLagZeroRows < y_lag_len ){
+            int y_lag_i = sim::ts1().moduloSteps(y_lag_len);
+            for( size_t g = 0; g < Genotypes::N(); ++g ) m_y_lag.at(y_lag_i, g) = 0.0;
+            ++m_yLagZeroRows;
+        }
+        return;
+    }
+    
     numInfs += nNewInfs;
     assert( numInfs>=0 && numInfs<=MAX_INFECTIONS );
     for( int i=0; i<nNewInfs; ++i ) {
@@ -162,6 +181,8 @@ void CommonWithinHost::update(LocalRng& rng,
     double survivalFactor_part = bsvFactor * _innateImmSurvFact;
     
     double body_mass = massByAge.eval( ageInYears ) * hetMassMultiplier;
+    // constant during the update: m_cumulative_h/Y are incremented afterwards
+    const ImmunityFactors immFactors = hostImmunityFactors( ageInYears );
     
     for( SimTime now = sim::ts0(), end = sim::ts0() + SimTime::oneTS(); now < end; now += SimTime::oneDay() ){
         // every day, medicate drugs, update each infection, then decay drugs
@@ -175,7 +196,7 @@ void CommonWithinHost::update(LocalRng& rng,
             
             if( !expires ){     /* no expiry due to simple treatment model; do update */
                 const double drugFactor = pkpdModel.getDrugFactor(rng, *inf, body_mass);
-                const double immFactor = immunitySurvivalFactor(ageInYears, (*inf)->cumulativeExposureJ());
+                const double immFactor = immunitySurvivalFactor(immFactors, (*inf)->cumulativeExposureJ());
                 const double survivalFactor = survivalFactor_part * immFactor * drugFactor;
                 // update, may result in termination of infection:
                 expires = (*inf)->update(rng, survivalFactor, now, body_mass);
@@ -218,6 +239,7 @@ void CommonWithinHost::update(LocalRng& rng,
     for( auto inf = infections.begin(); inf != infections.end(); ++inf ){
         m_y_lag.at( y_lag_i, (*inf)->genotype() ) += (*inf)->getDensity();
     }
+    m_yLagZeroRows = 0;
 }
 
 void CommonWithinHost::addProphylacticEffects(const vector<double>& pClearanceByTime) {
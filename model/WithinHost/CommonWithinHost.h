@@ -53,6 +53,10 @@ public:
     virtual void update (LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
             double ageInYears, double bsvFactor);
     
+    virtual bool isQuiescent() const{
+        return infections.empty() && pkpdModel.empty() && m_yLagZeroRows >= y_lag_len;
+    }
+    
     virtual void addProphylacticEffects(const vector<double>& pClearanceByTime);
     
     /** \brief Factory functions to create infections.
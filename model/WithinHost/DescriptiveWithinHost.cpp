@@ -21,6 +21,7 @@
 #include "Global.h"
 #include "Host/Human.h"
 #include "WithinHost/DescriptiveWithinHost.h"
+#include "WithinHost/Infection/DescriptiveBatch.h"
 #include "WithinHost/Diagnostic.h"
 #include "WithinHost/Genotypes.h"
 #include "WithinHost/Pathogenesis/PathogenesisModel.h"
@@ -28,6 +29,7 @@
 #include "util/StreamValidator.h"
 #include "util/errors.h"
 #include <cassert>
+#include <algorithm>
 
 using namespace std;
 
@@ -41,10 +43,12 @@ bool reportPatentInfected = false;
 
 void DescriptiveWithinHostModel::initDescriptive(){
     reportPatentInfected = mon::isUsedM(mon::MHR_PATENT_INFECTIONS);
+    DescriptiveBatch::init();
 }
 
 DescriptiveWithinHostModel::DescriptiveWithinHostModel( LocalRng& rng, double comorbidityFactor ) :
-        WHFalciparum( rng, comorbidityFactor )
+        WHFalciparum( rng, comorbidityFactor ),
+        m_batchFirst( 0 )
 {
     assert( SimTime::oneTS() == SimTime::fromDays(5) );
 }
@@ -59,16 +63,12 @@ void DescriptiveWithinHostModel::loadInfection(istream& stream) {
 }
 
 void DescriptiveWithinHostModel::clearInfections( Treatments::Stages stage ){
-    for(auto inf = infections.begin(); inf != infections.end();) {
-        if( stage == Treatments::BOTH ||
-            (stage == Treatments::LIVER && !inf->bloodStage()) ||
-            (stage == Treatments::BLOOD && inf->bloodStage())
-        ){
-            inf = infections.erase( inf );
-        }else{
-            ++inf;
-        }
-    }
+    infections.erase( std::remove_if( infections.begin(), infections.end(),
+        [stage]( const DescriptiveInfection& inf ){
+            return stage == Treatments::BOTH ||
+                (stage == Treatments::LIVER && !inf.bloodStage()) ||
+                (stage == Treatments::BLOOD && inf.bloodStage());
+        } ), infections.end() );
     numInfs = infections.size();
 }
 
@@ -97,9 +97,8 @@ void DescriptiveWithinHostModel::importInfection(LocalRng& rng){
 
 // -----  Density calculations  -----
 
-void DescriptiveWithinHostModel::update(LocalRng& rng,
-        int nNewInfs, vector<double>& genotype_weights,
-        double ageInYears, double bsvFactor)
+int DescriptiveWithinHostModel::addNewInfections(LocalRng& rng,
+        int nNewInfs, vector<double>& genotype_weights)
 {
     // Note: adding infections at the beginning of the update instead of the end
     // shouldn't be significant since before latentp delay nothing is updated.
@@ -111,7 +110,14 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
         infections.push_back(DescriptiveInfection (rng, genotype));
     }
     assert( numInfs == static_cast<int>(infections.size()) );
+    return nNewInfs;
+}
 
+void DescriptiveWithinHostModel::update(LocalRng& rng,
+        int nNewInfs, vector<double>& genotype_weights,
+        double ageInYears, double bsvFactor)
+{
+    nNewInfs = addNewInfections( rng, nNewInfs, genotype_weights );
     updateImmuneStatus ();
 
     totalDensity = 0.0;
@@ -120,8 +126,12 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
 
     bool treatmentLiver = treatExpiryLiver > sim::ts0();
     bool treatmentBlood = treatExpiryBlood > sim::ts0();
+    const ImmunityFactors immFactors = hostImmunityFactors( ageInYears );
+    const double stdlog = DescriptiveInfection::densityStdLog( m_cumulative_h );
     
-    for(auto inf = infections.begin(); inf != infections.end();) {
+    // Surviving infections are compacted towards the front (keeping order)
+    auto kept = infections.begin();
+    for(auto inf = infections.begin(); inf != infections.end(); ++inf) {
         //NOTE: it would be nice to combine this code with that in
         // CommonWithinHost.cpp, but a few changes would be needed:
         // INNATE_MAX_DENS and MAX_DENS_CORRECTION would need to be required
@@ -132,7 +142,6 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
         if ( inf->expired() /* infection has self-terminated */ ||
             (inf->bloodStage() ? treatmentBlood : treatmentLiver) )
         {
-            inf=infections.erase(inf);
             numInfs--;
             continue;
         }
@@ -140,8 +149,8 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
         // Should be: infStepMaxDens = 0.0, but has some history.
         // See MAX_DENS_CORRECTION in DescriptiveInfection.cpp.
         double infStepMaxDens = timeStepMaxDensity;
-        double immSurvFact = immunitySurvivalFactor(ageInYears, inf->cumulativeExposureJ());
-        inf->determineDensities(rng, m_cumulative_h, infStepMaxDens, immSurvFact, _innateImmSurvFact, bsvFactor);
+        double immSurvFact = immunitySurvivalFactor(immFactors, inf->cumulativeExposureJ());
+        inf->determineDensities(rng, stdlog, infStepMaxDens, immSurvFact, _innateImmSurvFact, bsvFactor);
 
         if (bugfix_max_dens)
             infStepMaxDens = std::max(infStepMaxDens, timeStepMaxDensity);
@@ -153,14 +162,75 @@ void DescriptiveWithinHostModel::update(LocalRng& rng,
             hrp2Density += density;
         }
 
-        ++inf;
+        if( kept != inf ) *kept = std::move( *inf );
+        ++kept;
     }
+    infections.erase( kept, infections.end() );
     
     // As in AJTMH p22, cumulative_h (X_h + 1) doesn't include infections added
     // this time-step and cumulative_Y only includes past densities.
     m_cumulative_h += nNewInfs;
     m_cumulative_Y += SimTime::oneTS().inDays() * totalDensity;
+    cacheDensities();
+}
+
+void DescriptiveWithinHostModel::updateStart(LocalRng& rng,
+        int nNewInfs, vector<double>& genotype_weights,
+        double ageInYears, double bsvFactor, const uint64_t streamKey[2])
+{
+    nNewInfs = addNewInfections( rng, nNewInfs, genotype_weights );
+    updateImmuneStatus ();
+    
+    // Remove infections which have self-terminated or been cleared by
+    // treatment, keeping order (see update())
+    bool treatmentLiver = treatExpiryLiver > sim::ts0();
+    bool treatmentBlood = treatExpiryBlood > sim::ts0();
+    infections.erase( std::remove_if( infections.begin(), infections.end(),
+        [treatmentLiver, treatmentBlood]( DescriptiveInfection& inf ){
+            return inf.expired() ||
+                (inf.bloodStage() ? treatmentBlood : treatmentLiver);
+        } ), infections.end() );
+    numInfs = infections.size();
+    
+    // Queue the others; densities are determined by DescriptiveBatch::sweep()
+    const ImmunityFactors immFactors = hostImmunityFactors( ageInYears );
+    m_batchFirst = DescriptiveBatch::addHost( streamKey,
+            DescriptiveInfection::densityStdLog( m_cumulative_h ),
+            _innateImmSurvFact, bsvFactor );
+    for( DescriptiveInfection& inf : infections ){
+        DescriptiveBatch::add( inf,
+                immunitySurvivalFactor(immFactors, inf.cumulativeExposureJ()) );
+    }
     
+    // As in update(), cumulative_h doesn't include infections added this step
+    m_cumulative_h += nNewInfs;
+}
+
+void DescriptiveWithinHostModel::updateFinish(){
+    totalDensity = 0.0;
+    hrp2Density = 0.0;
+    timeStepMaxDensity = 0.0;
+    
+    for( size_t i = 0; i < infections.size(); ++i ){
+        // See update()
+        double infStepMaxDens = timeStepMaxDensity;
+        DescriptiveBatch::timeStepMaxDensity( m_batchFirst + i, infStepMaxDens );
+        if (bugfix_max_dens)
+            infStepMaxDens = std::max(infStepMaxDens, timeStepMaxDensity);
+        timeStepMaxDensity = infStepMaxDens;
+        
+        double density = infections[i].getDensity();
+        totalDensity += density;
+        if( !infections[i].isHrp2Deficient() ){
+            hrp2Density += density;
+        }
+    }
+    
+    m_cumulative_Y += SimTime::oneTS().inDays() * totalDensity;
+    cacheDensities();
+}
+
+void DescriptiveWithinHostModel::cacheDensities(){
     util::streamValidate( totalDensity );
     util::streamValidate( hrp2Density );
     assert( (boost::math::isfinite)(totalDensity) );        // inf probably wouldn't be a problem but NaN would be
@@ -185,7 +255,7 @@ bool DescriptiveWithinHostModel::summarize( Host::Human& human )const{
         // genotype in this model
         mon::reportStatMHGI( mon::MHR_INFECTIONS, human, 0, infections.size() );
         if( reportPatentInfected ){
-            for(std::list<DescriptiveInfection>::const_iterator inf =
+            for(std::vector<DescriptiveInfection>::const_iterator inf =
                 infections.begin(); inf != infections.end(); ++inf) {
             if( diagnostics::monitoringDiagnostic().isPositive( human.rng(), inf->getDensity(), std::numeric_limits<double>::quiet_NaN() ) ){
                     mon::reportStatMHGI( mon::MHR_PATENT_INFECTIONS, human, 0, 1 );
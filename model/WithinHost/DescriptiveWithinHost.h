@@ -50,6 +50,9 @@ public:
     
     virtual void update(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
             double ageInYears, double bsvFactor);
+    virtual void updateStart(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
+            double ageInYears, double bsvFactor, const uint64_t streamKey[2]);
+    virtual void updateFinish();
     
     virtual bool summarize( Host::Human& human )const;
     
@@ -62,11 +65,21 @@ protected:
     // Doesn't do anything in this model:
     virtual void treatPkPd(size_t schedule, size_t dosages, double age, double delay_d);
     
+    /// Add new infections (part of update()); returns the number added
+    int addNewInfections(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights);
+    /// Validate and cache densities (end of update())
+    void cacheDensities();
+    
     /** The list of all infections this human has.
      * 
      * Since infection models and within host models are very much intertwined,
-     * the idea is that each WithinHostModel has its own list of infections. */
-     std::list<DescriptiveInfection> infections;
+     * the idea is that each WithinHostModel has its own list of infections.
+     * Stored contiguously; removal preserves order (as does the RNG usage). */
+     std::vector<DescriptiveInfection> infections;
+     
+     /// Batch index of the first infection between updateStart() and
+     /// updateFinish() (see DescriptiveBatch); not checkpointed.
+     size_t m_batchFirst;
 };
 
 } }
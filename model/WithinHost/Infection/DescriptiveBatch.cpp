@@ -0,0 +1,177 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "WithinHost/Infection/DescriptiveBatch.h"
+#include "util/ModelOptions.h"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+namespace OM {
+namespace WithinHost {
+
+extern bool bugfix_max_dens, bugfix_innate_max_dens;   // DescriptiveInfection.cpp
+
+bool DescriptiveBatch::s_enabled = false;
+uint64_t DescriptiveBatch::s_hostKey[2] = { 0, 0 };
+double DescriptiveBatch::s_hostStdLog = 0.0;
+double DescriptiveBatch::s_hostInnate = 1.0;
+double DescriptiveBatch::s_hostBSV = 1.0;
+SimTime DescriptiveBatch::s_lastStart = SimTime::never();
+uint32_t DescriptiveBatch::s_nSameStart = 0;
+
+std::vector<DescriptiveInfection*> DescriptiveBatch::infections;
+std::vector<int32_t> DescriptiveBatch::ageIndex;
+std::vector<int32_t> DescriptiveBatch::durIndex;
+std::vector<double> DescriptiveBatch::immSurvFact;
+std::vector<double> DescriptiveBatch::stdlog;
+std::vector<double> DescriptiveBatch::innate;
+std::vector<double> DescriptiveBatch::bsv;
+std::vector<uint64_t> DescriptiveBatch::key0;
+std::vector<uint64_t> DescriptiveBatch::key1;
+std::vector<uint64_t> DescriptiveBatch::counter;
+std::vector<double> DescriptiveBatch::density;
+std::vector<double> DescriptiveBatch::stepMax;
+
+void DescriptiveBatch::init(){
+    s_enabled = util::ModelOptions::option( util::BATCHED_DESCRIPTIVE_UPDATE );
+}
+
+void DescriptiveBatch::clear(){
+    infections.clear();
+    ageIndex.clear();
+    durIndex.clear();
+    immSurvFact.clear();
+    stdlog.clear();
+    innate.clear();
+    bsv.clear();
+    key0.clear();
+    key1.clear();
+    counter.clear();
+}
+
+size_t DescriptiveBatch::addHost( const uint64_t streamKey[2], double stdlog,
+        double innateImmSurvFact, double bsvFactor )
+{
+    s_hostKey[0] = streamKey[0];
+    s_hostKey[1] = streamKey[1];
+    s_hostStdLog = stdlog;
+    s_hostInnate = innateImmSurvFact;
+    s_hostBSV = bsvFactor;
+    s_lastStart = SimTime::never();
+    s_nSameStart = 0;
+    return infections.size();
+}
+
+void DescriptiveBatch::add( DescriptiveInfection& inf, double immSurvFact ){
+    // An infection is identified within its host by its start date and its
+    // order among infections with that date (which removal preserves).
+    if( inf.m_startDate == s_lastStart ){
+        s_nSameStart += 1;
+    }else{
+        s_lastStart = inf.m_startDate;
+        s_nSameStart = 0;
+    }
+    assert( s_nSameStart < 0x80 );
+
+    // As in DescriptiveInfection::determineDensities()
+    SimTime infage = sim::ts0() - inf.m_startDate - DescriptiveInfection::s_latentP;
+
+    infections.push_back( &inf );
+    ageIndex.push_back( infage < SimTime::zero() ? -1 :
+            std::min( infage.inSteps(), maxDurationTS ) );
+    durIndex.push_back( std::min( inf.m_duration.inSteps(), maxDurationTS ) );
+    DescriptiveBatch::immSurvFact.push_back( immSurvFact );
+    stdlog.push_back( s_hostStdLog );
+    innate.push_back( s_hostInnate );
+    bsv.push_back( s_hostBSV );
+    // Host streams (Human::seekRng()) use counters below 2^63. Here the top
+    // bit is set; the rest identifies the infection and the step.
+    key0.push_back( s_hostKey[0] );
+    key1.push_back( s_hostKey[1] );
+    counter.push_back( (uint64_t(1) << 63) |
+            (uint64_t(s_nSameStart) << 56) |
+            (uint64_t(inf.m_startDate.inSteps() & 0xFFFFFFF) << 28) |
+            uint64_t(sim::ts0().inSteps() & 0xFFFFFFF) );
+}
+
+void DescriptiveBatch::sweep(){
+    const size_t n = infections.size();
+    const int nDays = SimTime::oneTS().inDays();
+    density.resize( n );
+    stepMax.resize( n );
+
+    // The expected parasite density in the non naive host (AJTM p.9 eq. 9);
+    // zero until the blood stage is patent
+    for( size_t i = 0; i < n; ++i ){
+        density[i] = ageIndex[i] < 0 ? 0.0 :
+            pow( DescriptiveInfection::meanParasiteCount[ageIndex[i]][durIndex[i]],
+                 immSurvFact[i] );
+        stepMax[i] = 0.0;
+    }
+
+    // Perturb densities using a lognormal, with mean equal to the expected
+    // density (see determineDensities()), then sample the other T-1 days
+    LocalRng rng( 0, 0 );
+    for( size_t i = 0; i < n; ++i ){
+        if( ageIndex[i] < 0 || !(stdlog[i] > 0.0000001) ) continue;
+        rng.seed_counter( key0[i], key1[i], counter[i] );
+        double meanlog = log(density[i]) - stdlog[i]*stdlog[i] / 2.0;
+        density[i] = rng.log_normal( meanlog, stdlog[i] );
+        stepMax[i] = rng.max_multi_log_normal( density[i], nDays - 1,
+                meanlog, stdlog[i] );
+    }
+
+    // Limits, innate immunity and blood-stage vaccine; store results
+    for( size_t i = 0; i < n; ++i ){
+        DescriptiveInfection& inf = *infections[i];
+        if( ageIndex[i] < 0 ){
+            inf.m_density = 0.0;
+            continue;
+        }
+        if( stepMax[i] > maxDens && inf.notPrintedMDWarning ){
+            std::cerr << "TSMD hit limit:\t" << density[i] << ",\t" << stepMax[i] << std::endl;
+            inf.notPrintedMDWarning = false;
+        }
+        density[i] = std::min( density[i], maxDens ) * innate[i] * bsv[i];
+        stepMax[i] = std::min( stepMax[i], maxDens );
+        if( bugfix_innate_max_dens ) stepMax[i] *= innate[i];
+        stepMax[i] *= bsv[i];
+
+        inf.m_density = density[i];
+        inf.m_cumulativeExposureJ += nDays * density[i];
+    }
+}
+
+void DescriptiveBatch::timeStepMaxDensity( size_t i, double& timeStepMaxDensity ){
+    assert( i < stepMax.size() );
+    if( ageIndex[i] < 0 ){
+        if( bugfix_max_dens ) timeStepMaxDensity = 0.0;
+        if( bugfix_innate_max_dens ) timeStepMaxDensity *= innate[i];
+        timeStepMaxDensity *= bsv[i];
+    }else{
+        timeStepMaxDensity = stepMax[i];
+    }
+}
+
+}
+}
@@ -0,0 +1,102 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef Hmod_DescriptiveBatch
+#define Hmod_DescriptiveBatch
+
+#include "WithinHost/Infection/DescriptiveInfection.h"
+#include <vector>
+
+namespace OM { namespace WithinHost {
+
+/** Population-wide update of descriptive infection densities (model option
+ * BATCHED_DESCRIPTIVE_UPDATE).
+ *
+ * In the first pass of the human update, each host queues its infections
+ * here (DescriptiveWithinHostModel::updateStart()), which gathers what
+ * DescriptiveInfection::determineDensities() needs into contiguous arrays.
+ * sweep() then determines all densities and writes them back to the
+ * infections, and in the second pass hosts complete their update
+ * (DescriptiveWithinHostModel::updateFinish()).
+ *
+ * Density noise for an infection is drawn from a counter-based stream of its
+ * host's key (see COUNTER_BASED_HUMAN_RNG), the infection and the time step,
+ * so results do not depend on the order of the batch. */
+class DescriptiveBatch {
+public:
+    /// Read options. Call after ModelOptions are set.
+    static void init();
+
+    /// True when BATCHED_DESCRIPTIVE_UPDATE is enabled
+    static inline bool enabled(){ return s_enabled; }
+
+    /// Empty the batch; call before hosts queue infections for a step.
+    static void clear();
+
+    /** Start queueing the infections of a host.
+     *
+     * @param streamKey Key of the host's counter-based streams
+     * @param stdlog Result of DescriptiveInfection::densityStdLog()
+     * @param innateImmSurvFact Density multiplier for innate immunity
+     * @param bsvFactor Density multiplier for Blood-Stage Vaccine effect
+     * @returns The batch index of the host's first infection; later
+     *  infections follow consecutively. */
+    static size_t addHost( const uint64_t streamKey[2], double stdlog,
+            double innateImmSurvFact, double bsvFactor );
+
+    /** Queue an infection of the host last passed to addHost(). Infections of
+     * a host must be queued in order.
+     *
+     * @param immSurvFact Density exponent for acquired immunity */
+    static void add( DescriptiveInfection& inf, double immSurvFact );
+
+    /// Determine the densities of all queued infections.
+    static void sweep();
+
+    /** Update a host's maximum density over the step as
+     * DescriptiveInfection::determineDensities() does with its
+     * timeStepMaxDensity parameter, for the infection at batch index i. */
+    static void timeStepMaxDensity( size_t i, double& timeStepMaxDensity );
+
+private:
+    static bool s_enabled;
+
+    // Host being queued (see add())
+    static uint64_t s_hostKey[2];
+    static double s_hostStdLog, s_hostInnate, s_hostBSV;
+    static SimTime s_lastStart;         // start date of last infection queued
+    static uint32_t s_nSameStart;       // number queued of this host with this start date
+
+    /// @brief Queued infections (structure of arrays, by batch index)
+    //@{
+    static std::vector<DescriptiveInfection*> infections;
+    // row of DescriptiveInfection::meanParasiteCount: age in steps, or -1
+    // while not patent
+    static std::vector<int32_t> ageIndex;
+    static std::vector<int32_t> durIndex;
+    static std::vector<double> immSurvFact, stdlog, innate, bsv;
+    static std::vector<uint64_t> key0, key1, counter;   // noise stream
+    // Results: density and maximum density over the step
+    static std::vector<double> density, stepMax;
+    //@}
+};
+
+} }
+#endif
@@ -35,7 +35,7 @@ namespace WithinHost {
 using namespace util;
 
 // static class variables (see description in header file):
-double DescriptiveInfection::meanLogParasiteCount[numDurations][numDurations];
+double DescriptiveInfection::meanParasiteCount[numDurations][numDurations];
 double DescriptiveInfection::sigma0sq;
 double DescriptiveInfection::xNuStar;
 
@@ -49,7 +49,7 @@ void DescriptiveInfection::init (const Parameters& parameters) {
     if( SimTime::oneTS().inDays() != 5 ){
         // To support non-5-day time-step models, either different data would
         // be needed or times need to be adjusted when accessing
-        // meanLogParasiteCount. Probably the rest would be fine.
+        // meanParasiteCount. Probably the rest would be fine.
         throw util::xml_scenario_error ("DescriptiveInfection only supports using an interval of 5");
     }
     // Bug fixes: these are enabled by default but may be off in old parameterisations
@@ -102,11 +102,11 @@ void DescriptiveInfection::init (const Parameters& parameters) {
                 .append(densities_filename), Error::InputResource );
         }
 
-        //fill initial matrix
-        meanLogParasiteCount[i-1][j-1]=meanlogdens;
+        //fill initial matrix (exponentiated here rather than every update)
+        meanParasiteCount[i-1][j-1]=max(exp(meanlogdens), 1.0);
         //fill also the triangle that will not be used (to ensure everything is initialised)
         if (j!=i) {
-            meanLogParasiteCount[j-1][i-1]=0.0;
+            meanParasiteCount[j-1][i-1]=1.0;
         }
 
     }
@@ -143,7 +143,7 @@ SimTime DescriptiveInfection::infectionDuration(LocalRng& rng) {
 
 void DescriptiveInfection::determineDensities(
         LocalRng& rng,
-        double cumulativeh,
+        double stdlog,
         double &timeStepMaxDensity,
         double immSurvFact,
         double innateImmSurvFact,
@@ -160,16 +160,13 @@ void DescriptiveInfection::determineDensities(
         
         int32_t infAge = min( infage.inSteps(), maxDurationTS );
         int32_t infDur = min( m_duration.inSteps(), maxDurationTS );
-        m_density=max (exp(meanLogParasiteCount[infAge][infDur]), 1.0);
+        m_density=meanParasiteCount[infAge][infDur];
         
         // The expected parasite density in the non naive host (AJTM p.9 eq. 9)
         // Note that in published and current implementations Dx is zero.
         m_density = pow(m_density, immSurvFact);
         
-        //Perturb m_density using a lognormal
-        double varlog = sigma0sq / (1.0 + (cumulativeh / xNuStar));
-        double stdlog = sqrt(varlog);
-        
+        //Perturb m_density using a lognormal (stdlog from densityStdLog)
         /*
         This code samples from a log normal distribution with mean equal to the predicted density
         n.b. AJTM p.9 eq 9 implies that we sample the log of the density from a normal with mean equal to
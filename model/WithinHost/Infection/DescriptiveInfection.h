@@ -44,7 +44,7 @@ const double maxDens = 2000000;
  * 
  * This model was designed primarily for usage with a 5-day time-step, but is
  * mostly applicable to 1-4 day time-steps too. In such cases the indexes used
- * to access meanLogParasiteCount (or the data contained) would need adjusting.
+ * to access meanParasiteCount (or the data contained) would need adjusting.
  * 
  * Note that this class models only a single infection; for the associated
  * handling of multiple infections see the DescriptiveWithinHostModel class.
@@ -77,20 +77,28 @@ public:
         return sim::ts0() > m_startDate + m_duration;
     }
     
+    /** Standard deviation of the log-normal density noise (AJTM p.9 eq.
+     * 13). This depends only on the host, so is computed once per host and
+     * time step.
+     * 
+     * @param cumulativeh Cumulative number of infections */
+    static inline double densityStdLog( double cumulativeh ){
+        return sqrt( sigma0sq / (1.0 + (cumulativeh / xNuStar)) );
+    }
+    
     /** Determines parasite density of an individual infection (5-day time step
      * update)
      *
-     * @param ageInYears Age (of human)
-     * @param cumulativeh Cumulative number of infections
-     * @param cumulativeY Previous exposure (cumulative parasite density)
+     * @param stdlog Result of densityStdLog() for this host
      * @param timeStepMaxDensity (In-out param) Used to return the maximum
      *  parasite density over a 5-day interval.
+     * @param immSurvFact Density exponent for acquired immunity.
      * @param innateImmSurvFact Density multiplier for innate immunity.
      * @param bsvFactor Density multiplier for Blood-Stage Vaccine effect.
      */
     void determineDensities(
             LocalRng& rng,
-            double cumulativeh,
+            double stdlog,
             double &timeStepMaxDensity,
             double immSurvFact,
             double innateImmSurvFact,
@@ -120,16 +128,18 @@ protected:
 private:
     /// @brief Static parameters set by init()
     //@{
-    /* A triangular matrix: meanLogParasiteCount[i][j] is the
-     * Mean Log Parasite Count for age i (in time steps) of an infection which
-     * lasts j days. Indices with i>j are unused. */
-    static double meanLogParasiteCount[numDurations][numDurations];
+    /* A triangular matrix: meanParasiteCount[i][j] is max(exp(x), 1) where x
+     * is the Mean Log Parasite Count for age i (in time steps) of an
+     * infection which lasts j days. Indices with i>j are unused. */
+    static double meanParasiteCount[numDurations][numDurations];
     
     /// Sigma0^2 from AJTM p.9 eq. 13
     static double sigma0sq;
     /// XNuStar in AJTM p.9 eq. 13
     static double xNuStar;
     //@}
+    
+    friend class DescriptiveBatch;
 };
 
 } }
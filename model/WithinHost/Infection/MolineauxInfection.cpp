@@ -32,6 +32,10 @@
 #include <cmath>
 #include <boost/static_assert.hpp>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 
 namespace OM {
 namespace WithinHost {
@@ -149,6 +153,12 @@ const double case_specific_data[] = {
         404, 156240 // G48
 };
 
+#ifdef __SSE2__
+bool MolineauxInfection::useSIMD = true;
+#else
+bool MolineauxInfection::useSIMD = false;
+#endif
+
 // ———  static (non-class-member) code  ———
 
 CommonInfection* createMolineauxInfection (LocalRng& rng, uint32_t protID) {
@@ -205,6 +215,7 @@ void MolineauxInfection::init( const Parameters& parameters ){
 MolineauxInfection::MolineauxInfection(LocalRng& rng, uint32_t genotype):
         CommonInfection(genotype)
 {
+    clearVariants();
     for( size_t i = 0; i < v; i++ ){
         // Molineaux paper, equation 11
         if( multi_factor_gamma ){
@@ -249,11 +260,17 @@ MolineauxInfection::MolineauxInfection(LocalRng& rng, uint32_t genotype):
     }
 }
 
-MolineauxInfection::Variant::Variant () :
-        Pi1(0.0), Pi2(0.0), Si_summation(0.0)
-{
-    for(size_t tau=0; tau<taus; tau++){
-        lagged_Pi[tau] =  0.0;
+void MolineauxInfection::clearVariants(){
+    nVariants = 0;
+    for( size_t i = 0; i < v; i++ ){
+        Pi1[i] = 0.0;
+        Pi2[i] = 0.0;
+        Si_summation[i] = 0.0;
+    }
+    for( size_t tau = 0; tau < taus; tau++ ){
+        for( size_t i = 0; i < v; i++ ){
+            lagged_Pi[tau][i] = 0.0;
+        }
     }
 }
 
@@ -273,15 +290,15 @@ bool MolineauxInfection::updateDensity( LocalRng&, double survival_factor, SimTi
     if (age_BS == SimTime::zero()){
         // The first variant starts with a pre-set density (regardless of blood
         // volume; this is an assumption by DH; paper assumes fixed volume)
-        variants.resize(1);
+        nVariants = 1;
         Pi[0] = initial_dens;
         m_density = initial_dens;
     }else{
         double sum = 0.0;
-        for( size_t i = 0; i < variants.size(); i++ ){
-            double newP = survival_factor * variants[i].Pi1;
+        for( size_t i = 0; i < nVariants; i++ ){
+            double newP = survival_factor * Pi1[i];
             Pi[i] = newP;
-            variants[i].Pi1 = static_cast<float>(survival_factor * variants[i].Pi2);
+            Pi1[i] = static_cast<float>(survival_factor * Pi2[i]);
             sum += newP;
         }
         m_density = sum;
@@ -328,22 +345,35 @@ bool MolineauxInfection::updateDensity( LocalRng&, double survival_factor, SimTi
     //double Sm = (1.0 - beta) / (1.0 + pow(Sm_summation / Pm_star, kappa_m)) + beta
     const double Sm = (1.0 - beta) / (1.0 + Sm_summation / Pm_star) + beta;
     
+    // ———  4, 5: variant-specific immune response and densities  ———
+    if( useSIMD ){
+        updateVariantsSSE2( Pi, tau, Sc, Sm, elim_dens );
+    }else{
+        updateVariantsRef( Pi, tau, Sc, Sm, elim_dens );
+    }
+    
+    return false;       // end of update, not extinct
+}
+
+void MolineauxInfection::updateVariantsRef( const double* Pi, size_t tau,
+        double Sc, double Sm, double elim_dens )
+{
     // ———  4. variant-specific immune response (equation 6)  ———
     double Si[v];       // calculate value for each variant
     double sum_qj_Sj=0.0;       // simultaneously calculation summataion in equation 4
     
     for(size_t i = 0; i < v; i++){
-        if( i < variants.size() ){
+        if( i < nVariants ){
             // 4.a) Update the sum in (6) based on the last step's value
             //note: sigma_decay = exp(-2*sigma)
-            variants[i].Si_summation = static_cast<float>(
-                variants[i].Si_summation * sigma_decay + variants[i].lagged_Pi[tau]);
+            Si_summation[i] = static_cast<float>(
+                Si_summation[i] * sigma_decay + lagged_Pi[tau][i]);
             // 4.b) update history of density (P_i(t))
-            variants[i].lagged_Pi[tau] = static_cast<float>(Pi[i]);
+            lagged_Pi[tau][i] = static_cast<float>(Pi[i]);
             
             // 4.c) calculate S_i(t) (equation 6)
             BOOST_STATIC_ASSERT( kappa_v == 3 );        // again, optimise pow to multiplication
-            const double base = variants[i].Si_summation * inv_Pv_star;
+            const double base = Si_summation[i] * inv_Pv_star;
             Si[i] = 1.0 / (1.0 + base*base*base);        // eqn 6, given κ_v = 3
         }else{
             Si[i] = 1.0; // eqn 6 for the case when P_i(τ) = 0 for τ ≤ t - δ_m
@@ -352,6 +382,7 @@ bool MolineauxInfection::updateDensity( LocalRng&, double survival_factor, SimTi
     }
     
     // ———  5. Variant densities, equations 1, 2 and 4  ———
+    const size_t nOld = nVariants;
     for(size_t i = 0; i < v; i++ ){
         // 4.a) Calculate p_i, variant selection probability (eqn 4)
         double p_i = 0.0;
@@ -363,16 +394,16 @@ bool MolineauxInfection::updateDensity( LocalRng&, double survival_factor, SimTi
         // 4.b) calculate P_i'(t+2) [eqn 1] then P_i(t+2) [eqn 2]
         // This is the growth rate after taking immune effect into account:
         double growth_factor = mi[i] * Si[i] * Sc * Sm;   // part of eqn 1
-        if( i < variants.size() ){
+        if( i < nOld ){
             // Pi_prime: the variant's density at time t+2 (eqn 1)
             double Pi_prime = ( (1.0 - s) * Pi[i] + s * p_i * m_density ) * growth_factor;
             
             if( Pi_prime < elim_dens ) Pi_prime = 0.0;    // eqn 2
             
-            variants[i].Pi1 = static_cast<float>(sqrt(Pi[i] * Pi_prime));
-            variants[i].Pi2 = static_cast<float>(Pi_prime);
+            Pi1[i] = static_cast<float>(sqrt(Pi[i] * Pi_prime));
+            Pi2[i] = static_cast<float>(Pi_prime);
         }else{
-            // In this case P_i(τ) = 0 for all τ ≤ t, and we haven't allocated storage.
+            // In this case P_i(τ) = 0 for all τ ≤ t.
             
             // Pi_prime: the variant's density at time t+2 (eqn 1 in paper)
             double Pi_prime = ( s * p_i * m_density ) * growth_factor;
@@ -380,13 +411,88 @@ bool MolineauxInfection::updateDensity( LocalRng&, double survival_factor, SimTi
             // Molineaux paper equation 2
             if( Pi_prime >= elim_dens ){    // [if not, P_i(t+2) = 0]
                 // express a new variant at time t+2:
-                variants.resize( i+1 ); // allocate (potentially for multiple variants)
-                variants[i].Pi2 = static_cast<float>(Pi_prime);
+                nVariants = i+1;
+                Pi2[i] = static_cast<float>(Pi_prime);
             }
         }
     }
+}
+
+#ifdef __SSE2__
+namespace {
+// load/store two floats as two doubles
+inline __m128d load2f( const float* p ){
+    return _mm_cvtps_pd( _mm_castsi128_ps( _mm_loadl_epi64( reinterpret_cast<const __m128i*>(p) ) ) );
+}
+inline void store2f( float* p, __m128d x ){
+    _mm_storel_epi64( reinterpret_cast<__m128i*>(p), _mm_castps_si128( _mm_cvtpd_ps(x) ) );
+}
+}
+#endif
+
+void MolineauxInfection::updateVariantsSSE2( const double* Pi, size_t tau,
+        double Sc, double Sm, double elim_dens )
+{
+#ifdef __SSE2__
+    /* This is the same computation as updateVariantsRef, two variants at a
+     * time and in the same operation order, so the results are identical.
+     * Branches on whether a variant is expressed are not needed: all data
+     * of unexpressed variants is zero, which gives the same Si (1) and
+     * P_i'(t+2) as the special cases there. The sum in eqn 4 is still
+     * accumulated sequentially to preserve rounding. */
+    BOOST_STATIC_ASSERT( v % 2 == 0 );
+    BOOST_STATIC_ASSERT( kappa_v == 3 );
+    double Si[v];
+    
+    // ———  4. variant-specific immune response (equation 6)  ———
+    const __m128d one = _mm_set1_pd( 1.0 );
+    const __m128d decay = _mm_set1_pd( sigma_decay );
+    const __m128d invPv = _mm_set1_pd( inv_Pv_star );
+    for( size_t i = 0; i < v; i += 2 ){
+        __m128d sum = _mm_add_pd( _mm_mul_pd( load2f(Si_summation + i), decay ),
+                load2f(lagged_Pi[tau] + i) );
+        store2f( Si_summation + i, sum );
+        store2f( lagged_Pi[tau] + i, _mm_loadu_pd(Pi + i) );
+        // base uses the value after rounding to float, as stored
+        __m128d base = _mm_mul_pd( load2f(Si_summation + i), invPv );
+        __m128d cube = _mm_mul_pd( _mm_mul_pd( base, base ), base );
+        _mm_storeu_pd( Si + i, _mm_div_pd( one, _mm_add_pd( one, cube ) ) );
+    }
+    double sum_qj_Sj = 0.0;
+    for( size_t i = 0; i < v; i++ ){
+        sum_qj_Sj += qPow[i] * Si[i];    // sum in eqn 4
+    }
     
-    return false;       // end of update, not extinct
+    // ———  5. Variant densities, equations 1, 2 and 4  ———
+    const __m128d minSi = _mm_set1_pd( 0.1 );
+    const __m128d sumQS = _mm_set1_pd( sum_qj_Sj );
+    const __m128d vSc = _mm_set1_pd( Sc ), vSm = _mm_set1_pd( Sm );
+    const __m128d vs = _mm_set1_pd( s ), vNotS = _mm_set1_pd( 1.0 - s );
+    const __m128d density = _mm_set1_pd( m_density );
+    const __m128d elim = _mm_set1_pd( elim_dens );
+    for( size_t i = 0; i < v; i += 2 ){
+        __m128d si = _mm_loadu_pd( Si + i );
+        __m128d p_i = _mm_div_pd( _mm_mul_pd( _mm_loadu_pd(qPow + i), si ), sumQS );
+        p_i = _mm_and_pd( p_i, _mm_cmpge_pd( si, minSi ) );
+        __m128d growth = _mm_mul_pd( _mm_mul_pd( _mm_mul_pd( load2f(mi + i), si ), vSc ), vSm );
+        __m128d pi = _mm_loadu_pd( Pi + i );
+        __m128d prime = _mm_mul_pd( _mm_add_pd( _mm_mul_pd( vNotS, pi ),
+                _mm_mul_pd( _mm_mul_pd( vs, p_i ), density ) ), growth );
+        prime = _mm_and_pd( prime, _mm_cmpge_pd( prime, elim ) );     // eqn 2
+        store2f( Pi1 + i, _mm_sqrt_pd( _mm_mul_pd( pi, prime ) ) );
+        store2f( Pi2 + i, prime );
+    }
+    
+    // newly expressed variants
+    for( size_t i = v; i > nVariants; i-- ){
+        if( Pi2[i-1] != 0.0 ){
+            nVariants = i;
+            break;
+        }
+    }
+#else
+    updateVariantsRef( Pi, tau, Sc, Sm, elim_dens );
+#endif
 }
 
 // ———  MolineauxInfection: checkpointing  ———
@@ -394,11 +500,18 @@ bool MolineauxInfection::updateDensity( LocalRng&, double survival_factor, SimTi
 MolineauxInfection::MolineauxInfection (istream& stream) :
         CommonInfection(stream)
 {
+    clearVariants();
     Sm_summation & stream;
     for(size_t i=0;i<v;i++) {
         mi[i] & stream;
     }
-    variants & stream;
+    // same format as a vector of variants
+    nVariants & stream;
+    if( nVariants > v )
+        throw util::checkpoint_error( "MolineauxInfection: too many variants" );
+    for(size_t i=0;i<nVariants;i++) {
+        checkpointVariant( i, stream );
+    }
     for(size_t j=0;j<taus;j++){
         lagged_Pc[j] & stream;
     }
@@ -413,7 +526,10 @@ void MolineauxInfection::checkpoint (ostream& stream) {
     for(size_t i=0;i<v;i++) {
         mi[i] & stream;
     }
-    variants & stream;
+    nVariants & stream;
+    for(size_t i=0;i<nVariants;i++) {
+        checkpointVariant( i, stream );
+    }
     for(size_t j=0;j<taus;j++){
         lagged_Pc[j] & stream;
     }
@@ -421,33 +537,33 @@ void MolineauxInfection::checkpoint (ostream& stream) {
     Pm_star & stream;
 }
 
-void MolineauxInfection::Variant::operator& (istream& stream) {
+void MolineauxInfection::checkpointVariant (size_t i, istream& stream) {
     bool nonZero;
     nonZero & stream;
     if( nonZero ){
-        Pi1 & stream;
-        Pi2 & stream;
-        Si_summation & stream;
-        for(size_t i = 0; i < taus; ++i){
-            lagged_Pi[i] & stream;
+        Pi1[i] & stream;
+        Pi2[i] & stream;
+        Si_summation[i] & stream;
+        for(size_t tau = 0; tau < taus; ++tau){
+            lagged_Pi[tau][i] & stream;
         }
     }
-    // else: all members are zero-initialised by the constructor, so don't do anything
+    // else: all data is zero-initialised by clearVariants, so don't do anything
 }
 
-void MolineauxInfection::Variant::operator& (ostream& stream) {
+void MolineauxInfection::checkpointVariant (size_t i, ostream& stream) {
     bool nonZero =
-            Pi1 != 0.0 ||
-            Pi2 != 0.0 ||
-            Si_summation != 0.0;
+            Pi1[i] != 0.0 ||
+            Pi2[i] != 0.0 ||
+            Si_summation[i] != 0.0;
 
     nonZero & stream;
     if( nonZero ){
-        Pi1 & stream;
-        Pi2 & stream;
-        Si_summation & stream;
-        for(size_t i = 0; i < taus; ++i){
-            lagged_Pi[i] & stream;
+        Pi1[i] & stream;
+        Pi2[i] & stream;
+        Si_summation[i] & stream;
+        for(size_t tau = 0; tau < taus; ++tau){
+            lagged_Pi[tau][i] & stream;
         }
     }
 }
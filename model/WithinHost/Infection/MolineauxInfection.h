@@ -64,6 +64,20 @@ protected:
 private:
     double getVariantSpecificSummation(int i, double P_current);
     
+    /** Steps 4 and 5 of the update: variant-specific immune responses and
+     * new variant densities. Pi holds P_i(t) for all v variants (zero for
+     * those not expressed); tau is the lag index.
+     * 
+     * updateVariantsRef is the straightforward scalar version;
+     * updateVariantsSSE2 is vectorised and gives identical results. */
+    //@{
+    void updateVariantsRef( const double* Pi, size_t tau, double Sc, double Sm, double elim_dens );
+    void updateVariantsSSE2( const double* Pi, size_t tau, double Sc, double Sm, double elim_dens );
+    //@}
+    
+    /// Use updateVariantsSSE2 (default, when available)
+    static bool useSIMD;
+    
     // Note: we also have inherited parameters:
     // m_startDate is used to give the age here
     // m_density is equivalent to Pc in paper
@@ -78,21 +92,20 @@ private:
      * between the last positive day and the first positive day. */
     float Pc_star, Pm_star;
     
-    struct Variant {
-        // Initialise all variables to 0
-        Variant ();
-        
-        /// Checkpointing
-        void operator& (ostream& stream);
-        void operator& (istream& stream);
-        
-        float Pi1, Pi2;   // Pi(t+1), Pi(t+2): variant's i density (PRBC/μl blood)
-        float Si_summation;     // sum in eqn 6
-        // index: we use ((bsAge.inDays()/2) mod 4) for τ = t - δ_v respectively τ = t
-        float lagged_Pi[taus];   // Pi(τ) for τ ∈ {t - δ_v, ..., t - 2}
-    };
-    // variant-specific data; variants[i-1] corresponds to variant i in the paper
-    vector<Variant> variants;
+    /* Variant-specific data, as a structure of arrays; index i corresponds
+     * to variant i+1 in the paper. Only the first nVariants variants have
+     * been expressed; all data of the others is zero. */
+    size_t nVariants;
+    float Pi1[v], Pi2[v];   // Pi(t+1), Pi(t+2): variant's i density (PRBC/μl blood)
+    float Si_summation[v];      // sum in eqn 6
+    // index: we use ((bsAge.inDays()/2) mod 4) for τ = t - δ_v respectively τ = t
+    float lagged_Pi[taus][v];   // Pi(τ) for τ ∈ {t - δ_v, ..., t - 2}
+    
+    /// Set all variant data to zero
+    void clearVariants();
+    /// Checkpoint data of variant i (same format as the old Variant struct)
+    void checkpointVariant( size_t i, istream& stream );
+    void checkpointVariant( size_t i, ostream& stream );    ///< ditto
     
     // allow unittest to access private vars
     friend class ::MolineauxInfectionSuite;
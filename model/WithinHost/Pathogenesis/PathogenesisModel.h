@@ -69,6 +69,11 @@ public:
      * Only PyrogenPathogenesis implements this; other models don't have anything
      * to add to the summary. */
     virtual void summarize (const Host::Human& human) {}
+    
+    /** Apply the effect of determineState() over a number of skipped steps
+     * with zero parasite density (LAZY_QUIESCENT_HUMANS). Only state which
+     * changes without parasites need be updated; by default there is none. */
+    virtual void catchUpQuiescent (int steps) {}
 
     /// Checkpointing
     template<class S>
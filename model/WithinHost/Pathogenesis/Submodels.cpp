@@ -95,6 +95,12 @@ void PyrogenPathogenesis::summarize (const Host::Human& human) {
     mon::reportStatMHF( mon::MHF_LOG_PYROGENIC_THRESHOLD, human, log(_pyrogenThres+1.0) );
 }
 
+void PyrogenPathogenesis::catchUpQuiescent (int steps){
+    // the threshold decays without parasites; repeat the same iteration
+    for( int i = 0; i < steps; ++i )
+        updatePyrogenThres(0.0);
+}
+
 void PyrogenPathogenesis::updatePyrogenThres(double totalDensity){
     // Note: this calculation is slow (something like 5% of runtime)
     
@@ -54,6 +54,7 @@ public:
     virtual ~PyrogenPathogenesis() {}
     virtual void summarize (const Host::Human& human);
     virtual double getPEpisode(double timeStepMaxDensity, double totalDensity);
+    virtual void catchUpQuiescent (int steps);
     
     /// Read parameters from XML
     static void init( const OM::Parameters& parameters );
@@ -39,6 +39,7 @@
 #include "schema/scenario.h"
 
 #include <cmath>
+#include <limits>
 #include <boost/format.hpp>
 #include <gsl/gsl_cdf.h>
 
@@ -77,6 +78,44 @@ static double alpha_m;
 /// decay rate of maternal protection in years^(-1).
 static double decayM;
 
+/** Maternal immunity factor (Dm in AJTM) by age in days, for ages up to
+ * maternalSatDay (exclusive); at and after that age the factor is 1. If the
+ * factor does not reach 1 within the table, maternalSatDay is the maximum
+ * size_t value and larger ages are calculated directly. */
+static vector<double> maternalByDay;
+static size_t maternalSatDay;
+
+static void initMaternalTable(){
+    // Table size is limited; 20 years covers any reasonable decay rate.
+    const int maxDays = 20 * SimData::DAYS_IN_YEAR;
+    maternalByDay.clear();
+    maternalSatDay = numeric_limits<size_t>::max();
+    for( int d = 0; d < maxDays; ++d ){
+        const double x = alpha_m * exp(-decayM * SimTime::fromDays(d).inYears());
+        if( x < 1e-18 ){    // 1 - x is 1 here and at all older ages
+            maternalSatDay = d;
+            break;
+        }
+        maternalByDay.push_back( 1.0 - x );
+    }
+}
+
+/** Maternal immunity factor. Ages are usually a whole number of days (as
+ * given by SimTime::inYears()), so this is usually a table look-up giving
+ * exactly the same value as the calculation. */
+static inline double maternalFactor( double ageInYears ){
+    const double days = ageInYears * SimData::DAYS_IN_YEAR;
+    if( days >= 0.0 ){
+        const size_t d = static_cast<size_t>(days + 0.5);
+        // (the margin on the saturation threshold covers the rounding)
+        if( d >= maternalSatDay ) return 1.0;
+        if( d < maternalByDay.size() &&
+            SimTime::fromDays(static_cast<int>(d)).inYears() == ageInYears )
+            return maternalByDay[d];
+    }
+    return 1.0 - alpha_m * exp(-decayM * ageInYears);
+}
+
 SimTime Infection::s_latentP;
 int WHFalciparum::y_lag_len = 0;
 
@@ -95,6 +134,7 @@ void WHFalciparum::init( const OM::Parameters& parameters, const scnXml::Model&
     invCumulativeHstar = 1.0 / parameters[Parameters::CUMULATIVE_H_STAR];
     alpha_m = 1.0 - exp(-parameters[Parameters::NEG_LOG_ONE_MINUS_ALPHA_M]);
     decayM = parameters[Parameters::DECAY_M];
+    initMaternalTable();
     
     y_lag_len = SimTime::fromDays(20).inSteps() + 1;
     
@@ -116,6 +156,7 @@ void WHFalciparum::setParams(double cumYStar, double cumHStar, double aM, double
     invCumulativeHstar = cumHStar;
     alpha_m = aM;
     decayM = dM;
+    initMaternalTable();
 }
 
 
@@ -125,6 +166,7 @@ WHFalciparum::WHFalciparum( LocalRng& rng, double comorbidityFactor ):
     WHInterface(),
     m_cumulative_h(0.0), m_cumulative_Y(0.0), m_cumulative_Y_lag(0.0),
     totalDensity(0.0), hrp2Density(0.0), timeStepMaxDensity(0.0),
+    m_pTransTime(SimTime::never()),
     pathogenesisModel( Pathogenesis::PathogenesisModel::createPathogenesisModel( comorbidityFactor ) )
 {
     // NOTE: negating a Gaussian sample with mean 0 is pointless — except that
@@ -134,33 +176,47 @@ WHFalciparum::WHFalciparum( LocalRng& rng, double comorbidityFactor ):
     _innateImmSurvFact = exp(-rng.gauss(0.0, sigma_i));
     
     m_y_lag.assign(y_lag_len, Genotypes::N(), 0.0);
+    m_yLagZeroRows = 0;
 }
 
 WHFalciparum::~WHFalciparum()
 {
 }
 
-double WHFalciparum::immunitySurvivalFactor (double ageInYears, double cumulativeExposureJ) {
-    if (isnan(ageInYears) || isnan(cumulativeExposureJ) ||
-        isnan(m_cumulative_h) || isnan(m_cumulative_Y)) {
+WHFalciparum::ImmunityFactors WHFalciparum::hostImmunityFactors (double ageInYears) const{
+    if (isnan(ageInYears) || isnan(m_cumulative_h) || isnan(m_cumulative_Y)) {
         throw base_exception("nan in immunitySurvivalFactor");
     }
     
     // Documentation: AJTMH pp22-23
+    ImmunityFactors factors;
+    // Effect of number of infections experienced since birth (named Dh in AJTM)
+    factors.dH = 1.0;
+    // Effect of cumulative Parasite density (named Dy in AJTM) is per infection
+    factors.useDY = m_cumulative_h > 1.0;
+    if (factors.useDY) {
+        factors.dH = 1.0 / (1.0 + (m_cumulative_h - 1.0) * invCumulativeHstar);
+    }
+    
+    // Effect of age-dependent maternal immunity (named Dm in AJTM)
+    factors.dA = maternalFactor( ageInYears );
+    return factors;
+}
+
+double WHFalciparum::immunitySurvivalFactor (const ImmunityFactors& factors,
+        double cumulativeExposureJ) const
+{
+    if (isnan(cumulativeExposureJ)) {
+        throw base_exception("nan in immunitySurvivalFactor");
+    }
     
     // Effect of cumulative Parasite density (named Dy in AJTM)
     double dY = 1.0;
-    // Effect of number of infections experienced since birth (named Dh in AJTM)
-    double dH = 1.0;
-    if (m_cumulative_h > 1.0) {
-        dH = 1.0 / (1.0 + (m_cumulative_h - 1.0) * invCumulativeHstar);
+    if (factors.useDY) {
         dY = 1.0 / (1.0 + (m_cumulative_Y - cumulativeExposureJ) * invCumulativeYstar);
     }
     
-    // Effect of age-dependent maternal immunity (named Dm in AJTM)
-    double dA = 1.0 - alpha_m * exp(-decayM * ageInYears);
-    
-    return util::streamValidate( std::min(dY*dH*dA, 1.0) );
+    return util::streamValidate( std::min(dY*factors.dH*factors.dA, 1.0) );
 }
 
 // Infectiousness parameters: see AJTMH p.33; tau=1/sigmag**2 
@@ -172,6 +228,20 @@ const double PTM_tau_prime = 1.0 / sqrt(1.0 / PTM_tau);
 const double PTM_mu= -8.1;
 
 double WHFalciparum::probTransmissionToMosquito( double tbvFactor, double *sumX ) const{
+    // This is called by both VectorModel::vectorUpdate and updateKappa each
+    // step; the expensive part is only evaluated once.
+    if( m_pTransTime != sim::ts1() ){
+        updatePTransmit();
+    }
+    if( sumX != 0 ) *sumX = m_pTransInvX;    // copy to sumX, if set
+    if( m_pTransNoTBV == 0.0 ) return 0.0;  // uninfectious
+    
+    // Include here the effect of transmission-blocking vaccination:
+    double pTransmit = m_pTransNoTBV * tbvFactor;
+    util::streamValidate( pTransmit );
+    return pTransmit;
+}
+void WHFalciparum::updatePTransmit() const{
     // This model (often referred to as the gametocyte model) was designed for
     // 5-day time steps. We use the same model (sampling 10, 15 and 20 days
     // ago) for 1-day time steps to avoid having to design and analyse a new
@@ -193,8 +263,12 @@ double WHFalciparum::probTransmissionToMosquito( double tbvFactor, double *sumX
     }
     // Weighted sum:
     const double x = PTM_beta1 * y10 + PTM_beta2 * y15 + PTM_beta3 * y20;
-    if( sumX != 0 ) *sumX = 1.0 / x;    // copy to sumX, if set
-    if( x < 0.001 ) return 0.0; // cut off for uninfectious humans
+    m_pTransTime = sim::ts1();
+    m_pTransInvX = 1.0 / x;
+    if( x < 0.001 ){    // cut off for uninfectious humans
+        m_pTransNoTBV = 0.0;
+        return;
+    }
     
     // Get a zval, convert to equivalent Normal sample:
     const double zval = (log(x) + PTM_mu) * PTM_tau_prime;
@@ -203,11 +277,7 @@ double WHFalciparum::probTransmissionToMosquito( double tbvFactor, double *sumX
     // pTransmit has to be between 0 and 1:
     pTransmit=std::max(pTransmit, 0.0);
     pTransmit=std::min(pTransmit, 1.0);
-    
-    // Include here the effect of transmission-blocking vaccination:
-    pTransmit *= tbvFactor;
-    util::streamValidate( pTransmit );
-    return pTransmit;
+    m_pTransNoTBV = pTransmit;
 }
 double WHFalciparum::pTransGenotype(double pTrans, double sumX, size_t genotype)
 {
@@ -281,6 +351,15 @@ Pathogenesis::StatePair WHFalciparum::determineMorbidity( Host::Human& human,
 }
 
 
+void WHFalciparum::catchUpQuiescent(int steps){
+    // As the quiescent fast path in update() followed by determineMorbidity(),
+    // steps times; densities and the lag buffer are already zero.
+    for( int i = 0; i < steps; ++i )
+        updateImmuneStatus();
+    pathogenesisModel->catchUpQuiescent( steps );
+}
+
+
 // -----  immunity  -----
 
 void WHFalciparum::updateImmuneStatus() {
@@ -302,6 +381,7 @@ void WHFalciparum::updateImmuneStatus() {
 
 void WHFalciparum::checkpoint (istream& stream) {
     WHInterface::checkpoint( stream );
+    m_pTransTime = SimTime::never();
     _innateImmSurvFact & stream;
     m_cumulative_h & stream;
     m_cumulative_Y & stream;
@@ -310,6 +390,7 @@ void WHFalciparum::checkpoint (istream& stream) {
     hrp2Density & stream;
     timeStepMaxDensity & stream;
     m_y_lag & stream;
+    m_yLagZeroRows & stream;
     (*pathogenesisModel) & stream;
     treatExpiryLiver & stream;
     treatExpiryBlood & stream;
@@ -324,6 +405,7 @@ void WHFalciparum::checkpoint (ostream& stream) {
     hrp2Density & stream;
     timeStepMaxDensity & stream;
     m_y_lag & stream;
+    m_yLagZeroRows & stream;
     (*pathogenesisModel) & stream;
     treatExpiryLiver & stream;
     treatExpiryBlood & stream;
@@ -70,6 +70,8 @@ public:
     virtual bool treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBlood );
     
     virtual Pathogenesis::StatePair determineMorbidity( Host::Human& human, double ageYears, bool isDoomed );
+    
+    virtual void catchUpQuiescent(int steps);
 
     inline double getCumulative_h() const {
         return m_cumulative_h;
@@ -93,6 +95,18 @@ protected:
      * Applies decay of immunity against asexual blood stages, if present. */
     void updateImmuneStatus();
 
+    /** Parts of immunitySurvivalFactor which depend only on the host and
+     * step (not the infection). */
+    struct ImmunityFactors {
+        double dH;      // effect of number of infections (Dh in AJTM)
+        double dA;      // effect of maternal immunity (Dm in AJTM)
+        bool useDY;     // whether the effect of cumulative density applies
+    };
+    
+    /** Calculate the host-level parts of immunitySurvivalFactor. Valid until
+     * m_cumulative_h or m_cumulative_Y change (i.e. for a whole update). */
+    ImmunityFactors hostImmunityFactors (double ageInYears) const;
+    
     /** @returns A multiplier describing the proportion of parasites surviving
      * immunity effects this time step.
      * 
@@ -100,7 +114,14 @@ protected:
      * new density has no effect on future densities, wheras the Empirical model
      * multiplies the actual density (which then affects density on the following
      * time step). */
-    double immunitySurvivalFactor (double ageInYears, double cumulativeExposureJ);
+    double immunitySurvivalFactor (const ImmunityFactors& factors, double cumulativeExposureJ) const;
+    /// Convenience version of the above
+    inline double immunitySurvivalFactor (double ageInYears, double cumulativeExposureJ) const{
+        return immunitySurvivalFactor( hostImmunityFactors(ageInYears), cumulativeExposureJ );
+    }
+    
+    /// Evaluate m_pTransNoTBV and m_pTransInvX for the current step
+    void updatePTransmit() const;
     
     //!innate ability to control parasite densities
     double _innateImmSurvFact;
@@ -131,6 +152,17 @@ protected:
     * m_y_lag[sim::ts0().moduloSteps(y_lag_len)] corresponds to the density
     * from the previous time step (once updateInfection has been called). */
     vector2D<double> m_y_lag;
+    /** Number of the most recently written rows of m_y_lag which are known
+     * to be zero (at most y_lag_len), so that quiescent hosts need not reset
+     * them. */
+    int m_yLagZeroRows;
+    
+    /** Memoised intermediate results of probTransmissionToMosquito(): the
+     * probability excluding the TBV factor and 1/x. These depend only on
+     * m_y_lag rows which are not written during the step in which they are
+     * read, so are valid while m_pTransTime == sim::ts1(). Not checkpointed. */
+    mutable SimTime m_pTransTime;
+    mutable double m_pTransNoTBV, m_pTransInvX;
     
     /// The PathogenesisModel introduces illness dependant on parasite density
     unique_ptr<Pathogenesis::PathogenesisModel> pathogenesisModel;
@@ -104,6 +104,14 @@ unique_ptr<WHInterface> WHInterface::createWithinHostModel(LocalRng& rng, double
 
 // -----  Non-static  -----
 
+void WHInterface::updateStart(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
+        double ageInYears, double bsvFactor, const uint64_t streamKey[2])
+{
+    throw TRACED_EXCEPTION_DEFAULT( "batched update not supported by this within-host model" );
+}
+void WHInterface::updateFinish(){
+    throw TRACED_EXCEPTION_DEFAULT( "batched update not supported by this within-host model" );
+}
 
 void WHInterface::checkpoint (istream& stream) {
     numInfs & stream;
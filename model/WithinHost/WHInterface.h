@@ -167,6 +167,28 @@ public:
      */
     virtual void update(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
             double ageInYears, double bsvFactor) =0;
+    
+    /** As update(), but in two parts, between which the densities of all
+     * infections in the population are determined in a batch (see
+     * BATCHED_DESCRIPTIVE_UPDATE). Only the descriptive model supports this.
+     * 
+     * updateStart() takes the parameters of update(), plus the key of the
+     * human's counter-based streams; updateFinish() is called after
+     * DescriptiveBatch::sweep(). */
+    virtual void updateStart(LocalRng& rng, int nNewInfs, vector<double>& genotype_weights,
+            double ageInYears, double bsvFactor, const uint64_t streamKey[2]);
+    virtual void updateFinish();
+    
+    /** True when update() with no new infections would only decay immunity:
+     * there are no infections, no drugs and no recent parasite densities
+     * (used by LAZY_QUIESCENT_HUMANS). Models which don't support skipping
+     * updates return false. */
+    virtual bool isQuiescent() const { return false; }
+    
+    /** Apply the effect of a number of skipped updates (and pathogenesis
+     * evaluations) of a quiescent host. Only called when isQuiescent() was
+     * true when updates started being skipped. */
+    virtual void catchUpQuiescent(int steps) {}
 
     /** TODO: this should not need to be exposed. It is currently used by a
      * severe outcome (pDeath) model inside the EventScheduler "case
@@ -283,6 +283,7 @@ void VivaxBrood::treatmentLS(){
 // ———  per-host code  ———
 
 WHVivax::WHVivax( LocalRng& rng, double comorbidityFactor ) :
+    nextBroodEvent(SimTime::zero()),
     cumPrimInf(0),
     pEvent( numeric_limits<double>::quiet_NaN() ),
     pFirstRelapseEvent( numeric_limits<double>::quiet_NaN() ),
@@ -345,6 +346,7 @@ bool WHVivax::summarize(Host::Human& human) const{
 void WHVivax::importInfection(LocalRng& rng){
     // this means one new liver stage infection, which can result in multiple blood stages
     infections.push_back( VivaxBrood( rng, this ) );
+    nextBroodEvent = SimTime::zero();
 }
 
 void WHVivax::update(LocalRng& rng,
@@ -366,8 +368,21 @@ void WHVivax::update(LocalRng& rng,
     double oldpEvent = ( isnan(pEvent))? 1.0 : pEvent;
     // always use the first relapse probability for following relapses as a factor
     double oldpRelapseEvent = ( isnan(pFirstRelapseEvent))? 1.0 : pFirstRelapseEvent;
-    auto inf = infections.begin();
-    while( inf != infections.end() ){
+    
+    // Broods only do anything on hypnozoite release, blood-stage clearance
+    // (when finished) or treatment. Other steps need no per-brood work
+    // (and make no random draws).
+    if( nNewInfs == 0 && !treatmentLiver && !treatmentBlood &&
+        nextBroodEvent > sim::ts0() )
+    {
+        morbidity = Pathogenesis::PathogenesisModel::sampleNMF( rng, ageInYears );
+        return;
+    }
+    
+    // Unfinished broods are compacted towards the front (keeping order)
+    nextBroodEvent = SimTime::future();
+    auto kept = infections.begin();
+    for( auto inf = infections.begin(); inf != infections.end(); ++inf ){
         if( treatmentLiver ) inf->treatmentLS();
         if( treatmentBlood ) inf->treatmentBS();        // clearnace due to treatment; no protection against reemergence
         VivaxBrood::UpdResult result = inf->update(rng);
@@ -410,9 +425,12 @@ void WHVivax::update(LocalRng& rng,
             }
         }
         
-        if( result.isFinished ) inf = infections.erase( inf );
-        else ++inf;
+        if( result.isFinished ) continue;
+        nextBroodEvent = min( nextBroodEvent, inf->nextEvent() );
+        if( kept != inf ) *kept = std::move( *inf );
+        ++kept;
     }
+    infections.erase( kept, infections.end() );
     
     //TODO were pEvent and pFirstRelapseEvent meant to get updated?
     
@@ -461,6 +479,7 @@ void WHVivax::optionalPqTreatment( Host::Human& human ){
             for( auto it = infections.begin(); it != infections.end(); ++it ){
                 it->treatmentLS();
             }
+            nextBroodEvent = SimTime::zero();
         }
         mon::reportEventMHI( mon::MHT_LS_TREATMENTS, human, 1 );
     }
@@ -484,6 +503,7 @@ bool WHVivax::treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBl
                 for( auto it = infections.begin(); it != infections.end(); ++it ){
                     it->treatmentLS();
                 }
+                nextBroodEvent = SimTime::zero();
             }
         }
         mon::reportEventMHI( mon::MHT_LS_TREATMENTS, human, 1 );
@@ -496,6 +516,7 @@ bool WHVivax::treatSimple( Host::Human& human, SimTime timeLiver, SimTime timeBl
             for( auto it = infections.begin(); it != infections.end(); ++it ){
                 it->treatmentBS();
             }
+            nextBroodEvent = SimTime::zero();
         }else{
             treatExpiryBlood = max( treatExpiryBlood, sim::nowOrTs1() + timeBlood );
         }
@@ -24,7 +24,7 @@
 #include "Global.h"
 #include "WithinHost/WHInterface.h"
 
-#include <list>
+#include <vector>
 #include <memory>
 
 using namespace std;
@@ -64,6 +64,10 @@ public:
     /** Create from checkpoint. */
     VivaxBrood( istream& stream );
     
+    /// Allow moving (broods are stored in a vector)
+    VivaxBrood( VivaxBrood&& ) = default;
+    VivaxBrood& operator=( VivaxBrood&& ) = default;
+    
     struct UpdResult{
         UpdResult() : newPrimaryBS(false), newRelapseBS(false), newBS(false) {}
         bool newPrimaryBS, newRelapseBS, newBS, isFinished;
@@ -78,6 +82,13 @@ public:
      */
     UpdResult update(LocalRng& rng);
     
+    /** The start of the first time step on which update() may do anything
+     * (release a hypnozoite or finish), assuming no treatment before then.
+     * Only valid after update(). */
+    inline SimTime nextEvent() const{
+        return releaseDates.empty() ? bloodStageClearDate : releaseDates.back();
+    }
+    
     inline void setHadEvent( bool hadEvent ){ this->hadEvent = hadEvent; }
     inline bool hasHadEvent()const{ return hadEvent; }
     inline void setHadRelapse( bool hadRelapse ){ this->hadRelapse = hadRelapse; }
@@ -181,7 +192,12 @@ private:
     WHVivax( const WHVivax& ) = delete;
     WHVivax& operator= (const WHVivax& ) = delete;
     
-    list<VivaxBrood> infections;
+    vector<VivaxBrood> infections;
+    
+    /* Earliest time step start at which any brood needs updating (the
+     * minimum of VivaxBrood::nextEvent()); not checkpointed. Set to zero when
+     * broods are added or treated outside of update(), forcing an update. */
+    SimTime nextBroodEvent;
     
     /* Is flagged as never getting PQ: this is a heteogeneity factor. Example:
      * Set to zero if everyone can get PQ, 0.5 if females can't get PQ and
@@ -165,7 +165,11 @@ protected:
         vaccLimits.set( deploy );
     }
     
+    /** Deploy to a human, waking it first (LAZY_QUIESCENT_HUMANS). Selection
+     * only uses age, sub-population membership and the human's RNG, none of
+     * which depend on skipped updates, so only recipients need waking. */
     inline void deployToHuman( Host::Human& human, mon::Deploy::Method method ) const{
+        human.wake();
         intervention->deploy( human, method, vaccLimits );
     }
     
@@ -204,16 +208,51 @@ public:
     }
     
     virtual void deploy (Population& population, Transmission::TransmissionModel& transmission) {
-        for(Human& human : population) {
-            SimTime age = human.age(sim::now());
-            if( age >= minAge && age < maxAge ){
-                if( subPop == ComponentId::wholePop() || (human.isInSubPop( subPop ) != complement) ){
-                    if( human.rng().bernoulli( coverage ) ){
-                        deployToHuman( human, mon::Deploy::TIMED );
-                    }
-                }
+        if( InterventionManager::fastSampling() ){
+            deployFast( population );
+            return;
+        }
+        forEachEligible( population, [this]( Human& human ){
+            if( human.rng().bernoulli( coverage ) ){
+                deployToHuman( human, mon::Deploy::TIMED );
+            }
+        } );
+    }
+    
+    /** Deploy with population-level sampling (FAST_DEPLOYMENT_SAMPLING):
+     * instead of one Bernoulli sample per eligible human, the number of
+     * eligible humans to pass over before the next recipient is sampled
+     * from the deployment RNG.
+     * 
+     * The age band is a contiguous range of the population (ordered by date
+     * of birth). Without a sub-population restriction we jump straight to
+     * each recipient, so the cost is proportional to the number of
+     * recipients (plus a binary search); otherwise eligible humans are
+     * visited as in forEachEligible(). */
+    void deployFast (Population& population) {
+        if( coverage <= 0.0 ) return;
+        util::BlockRng& rng = InterventionManager::deploymentRng();
+        if( subPop == ComponentId::wholePop() ){
+            auto range = population.ageRange( minAge, maxAge );
+            const uint64_t size = range.second - range.first;
+            uint64_t i = rng.geometric_skip( coverage );
+            while( i < size ){
+                deployToHuman( *(range.first + i), mon::Deploy::TIMED );
+                uint64_t skip = rng.geometric_skip( coverage );
+                if( skip >= size ) break;
+                i += skip + 1;
             }
+            return;
         }
+        uint64_t skip = rng.geometric_skip( coverage );
+        forEachEligible( population, [&]( Human& human ){
+            if( skip == 0 ){
+                deployToHuman( human, mon::Deploy::TIMED );
+                skip = rng.geometric_skip( coverage );
+            }else{
+                skip -= 1;
+            }
+        } );
     }
     
     virtual void print_details( std::ostream& out )const{
@@ -226,6 +265,29 @@ public:
     }
     
 protected:
+    /** Call f(human) for each human within the age and sub-population
+     * restrictions, in population order. The age band is found by binary
+     * search; members of a sub-population are found through the
+     * sub-population index (see Host::SubPopIndex), so the cost of a
+     * restricted deployment is proportional to the number of members. Only
+     * the complement of a sub-population requires checking every human in
+     * the age band. */
+    template<class F>
+    void forEachEligible( Population& population, F f ){
+        auto range = population.ageRange( minAge, maxAge );
+        if( subPop == ComponentId::wholePop() ){
+            for( auto it = range.first; it != range.second; ++it ) f( *it );
+        }else if( !complement ){
+            population.forEachListedMember( subPop, range, [&]( Human& human ){
+                if( human.isInSubPop( subPop ) ) f( human );
+            } );
+        }else{
+            for( auto it = range.first; it != range.second; ++it ){
+                if( !it->isInSubPop( subPop ) ) f( *it );
+            }
+        }
+    }
+    
     // restrictions on deployment
     SimTime minAge, maxAge;
 };
@@ -255,16 +317,11 @@ public:
         // Cumulative case: bring target group's coverage up to target coverage
         vector<Host::Human*> unprotected;
         size_t total = 0;       // number of humans within age bound and optionally subPop
-        for(Population::Iter iter = population.begin(); iter != population.end(); ++iter) {
-            SimTime age = iter->age(sim::now());
-            if( age >= minAge && age < maxAge ){
-                if( subPop == ComponentId::wholePop() || (iter->isInSubPop( subPop ) != complement) ){
-                    total+=1;
-                    if( !iter->isInSubPop(cumCovInd) )
-                        unprotected.push_back( &*iter );
-                }
-            }
-        }
+        forEachEligible( population, [&]( Human& human ){
+            total+=1;
+            if( !human.isInSubPop(cumCovInd) )
+                unprotected.push_back( &human );
+        } );
         
         if( total == 0 ) return;        // no humans to deploy to; avoid divide by zero
         double propProtected = static_cast<double>( total - unprotected.size() ) / static_cast<double>( total );
@@ -354,28 +411,27 @@ public:
         }
     }
     
-    /** Apply filters and potentially deploy.
+    /// Age at which humans receive this deployment
+    inline SimTime targetAge() const{ return deployAge; }
+    
+    /// True if deployment is active at the current date
+    inline bool isActive() const{
+        auto now = sim::intervDate();
+        return begin <= now && now < end;
+    }
+    
+    /** Apply filters and potentially deploy to a human of the target age.
      * 
-     * @returns false iff this deployment (and thus all later ones in the
-     *  ordered list) happens in the future. */
-    bool filterAndDeploy( Host::Human& human, const Population& population ) const{
-        SimTime age = human.age(sim::now());
-        if( deployAge > age ){
-            // stop processing continuous deployments for this
-            // human for now because remaining ones happen in the future
-            return false;
-        }else if( deployAge == age ){
-            auto now = sim::intervDate();
-            if( begin <= now && now < end &&
-                ( subPop == ComponentId::wholePop() ||
-                    (human.isInSubPop( subPop ) != complement)
-                ) &&
-                human.rng().uniform_01() < coverage )     // RNG call should be last test
-            {
-                deployToHuman( human, mon::Deploy::CTS );
-            }
-        }//else: for some reason, a deployment age was missed; ignore it
-        return true;
+     * Should only be called when isActive(). */
+    void filterAndDeploy( Host::Human& human ) const{
+        assert( human.age(sim::now()) == deployAge );
+        if( ( subPop == ComponentId::wholePop() ||
+                (human.isInSubPop( subPop ) != complement)
+            ) &&
+            human.rng().uniform_01() < coverage )     // RNG call should be last test
+        {
+            deployToHuman( human, mon::Deploy::CTS );
+        }
     }
     
     inline void print_details( std::ostream& out )const{
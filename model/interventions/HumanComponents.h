@@ -104,7 +104,7 @@ private:
 /** Per-human vaccine code. */
 class PerHumanVaccine {
 public:
-    PerHumanVaccine() {}
+    PerHumanVaccine() : factorsTime(SimTime::never()) {}
     
     /** Get one minus the efficacy of the vaccine (1 for no effect, 0 for full effect). */
     double getFactor( Vaccine::Types type )const;
@@ -128,12 +128,23 @@ public:
     template<class S>
     void operator& (S& stream) {
         effects & stream;
+        factorsTime = SimTime::never();
     }
 
 private:
+    /// Evaluate factors for all vaccine types at the current time
+    void updateFactors()const;
+    
     /// Details for each deployed vaccine for this human
     typedef std::vector<PerEffectPerHumanVaccine> EffectList;
     EffectList effects;
+    
+    // Cache of getFactor() results for each type (not checkpointed). Factors
+    // are requested several times per step (TBV by both vectorUpdate and
+    // updateKappa); the cache is valid while factorsTime equals sim::ts1()
+    // and is invalidated on vaccination.
+    mutable SimTime factorsTime;
+    mutable double factors[Vaccine::NumVaccineTypes];
 };
 
 }
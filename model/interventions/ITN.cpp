@@ -624,7 +624,8 @@ void ITNComponent::ITNAnopheles::init(
 HumanITN::HumanITN( LocalRng& rng, const ITNComponent& params ) :
         PerHostInterventionData( params.id() ),
         nHoles( 0 ),
-        holeIndex( 0.0 )
+        holeIndex( 0.0 ),
+        effectsTime( SimTime::never() )
 {
     // Net rips and insecticide loss are assumed to co-vary dependent on
     // handling of net. They are sampled once per human: human handling is
@@ -651,6 +652,7 @@ void HumanITN::redeploy(LocalRng& rng, const OM::Transmission::HumanVectorInterv
     disposalTime = sim::nowOrTs1() + params.attritionOfNets->sampleAgeOfDecay(rng);
     nHoles = 0;
     holeIndex = 0.0;
+    effectsTime = SimTime::never();
     // this is sampled independently: initial insecticide content doesn't depend on handling
     initialInsecticide = params.initialInsecticide.sample(rng);
     if( initialInsecticide < 0.0 )
@@ -672,34 +674,44 @@ void HumanITN::update(Host::Human& human){
         int newHoles = human.rng().poisson( holeRate );
         nHoles += newHoles;
         holeIndex += newHoles + params.ripFactor * human.rng().poisson( nHoles * ripRate );
+        
+        // Hole index changed: evaluate effects once for the rest of this step
+        updateEffects();
+    }
+}
+
+void HumanITN::updateEffects() const{
+    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
+    const double insecticideContent = getInsecticideContent(params);
+    effectsCache.resize( params.species.size() );
+    for( size_t i = 0; i < params.species.size(); ++i ){
+        const ITNComponent::ITNAnopheles& anoph = params.species[i];
+        SpeciesEffects& eff = effectsCache[i];
+        eff.relAttractiveness = anoph.relativeAttractiveness( holeIndex, insecticideContent );
+        eff.preprandialSurvivalFactor = anoph.preprandialSurvivalFactor( holeIndex, insecticideContent );
+        eff.postprandialSurvivalFactor = anoph.postprandialSurvivalFactor( holeIndex, insecticideContent );
+        eff.relFecundity = anoph.relFecundity( holeIndex, insecticideContent );
     }
+    effectsTime = sim::nowOrTs1();
 }
 
 double HumanITN::relativeAttractiveness(size_t speciesIndex) const{
     if( deployTime == SimTime::never() ) return 1.0;
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
-    const ITNComponent::ITNAnopheles& anoph = params.species[speciesIndex];
-    return anoph.relativeAttractiveness( holeIndex, getInsecticideContent(params) );
+    return effects(speciesIndex).relAttractiveness;
 }
 
 double HumanITN::preprandialSurvivalFactor(size_t speciesIndex) const{
     if( deployTime == SimTime::never() ) return 1.0;
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
-    const ITNComponent::ITNAnopheles& anoph = params.species[speciesIndex];
-    return anoph.preprandialSurvivalFactor( holeIndex, getInsecticideContent(params) );
+    return effects(speciesIndex).preprandialSurvivalFactor;
 }
 
 double HumanITN::postprandialSurvivalFactor(size_t speciesIndex) const{
     if( deployTime == SimTime::never() ) return 1.0;
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
-    const ITNComponent::ITNAnopheles& anoph = params.species[speciesIndex];
-    return anoph.postprandialSurvivalFactor( holeIndex, getInsecticideContent(params) );
+    return effects(speciesIndex).postprandialSurvivalFactor;
 }
 double HumanITN::relFecundity(size_t speciesIndex) const{
     if( deployTime == SimTime::never() ) return 1.0;
-    const ITNComponent& params = *ITNComponent::componentsByIndex[m_id.id];
-    const ITNComponent::ITNAnopheles& anoph = params.species[speciesIndex];
-    return anoph.relFecundity( holeIndex, getInsecticideContent(params) );
+    return effects(speciesIndex).relFecundity;
 }
 
 void HumanITN::checkpoint( ostream& stream ){
@@ -712,7 +724,9 @@ void HumanITN::checkpoint( ostream& stream ){
     ripRate & stream;
     insecticideDecayHet & stream;
 }
-HumanITN::HumanITN( istream& stream, ComponentId id ) : PerHostInterventionData( id )
+HumanITN::HumanITN( istream& stream, ComponentId id ) :
+        PerHostInterventionData( id ),
+        effectsTime( SimTime::never() )
 {
     deployTime & stream;
     disposalTime & stream;
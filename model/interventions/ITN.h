@@ -262,6 +262,23 @@ protected:
     virtual void checkpoint( ostream& stream );
     
 private:
+    /// Per-species effects of this net, as returned by the getters above.
+    struct SpeciesEffects {
+        double relAttractiveness;
+        double preprandialSurvivalFactor;
+        double postprandialSurvivalFactor;
+        double relFecundity;
+    };
+    
+    /// Get effects for a species, recalculating the cache if it was not
+    /// calculated for the current time and net state.
+    inline const SpeciesEffects& effects( size_t speciesIndex )const{
+        if( effectsTime != sim::nowOrTs1() ) updateEffects();
+        return effectsCache[speciesIndex];
+    }
+    /// Evaluate insecticide content and all per-species effects (expensive).
+    void updateEffects()const;
+    
     // these parameters express the current state of the net:
     SimTime disposalTime;	// time at which net will be disposed of (if it's not already been replaced)
     int nHoles;				// total number of holes
@@ -272,6 +289,13 @@ private:
     double holeRate;	// rate at which new holes are created (holes/time-step)
     double ripRate;		// rate at which holes are enlarged (rips/hole/time-step)
     DecayFuncHet insecticideDecayHet;
+    
+    // Cache of effects (not checkpointed). Inputs are holeIndex and insecticide
+    // content; the latter depends on time, so the cache is valid only while
+    // effectsTime equals sim::nowOrTs1() (and is invalidated by setting
+    // effectsTime to SimTime::never() whenever the net state changes).
+    mutable SimTime effectsTime;
+    mutable vector<SpeciesEffects> effectsCache;
 };
 
 } }
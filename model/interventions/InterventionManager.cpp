@@ -21,6 +21,7 @@
 #include "interventions/InterventionManager.hpp"
 #include "Population.h"
 #include "util/CommandLine.h"
+#include "util/ModelOptions.h"
 #include "util/timeConversions.h"
 #include "interventions/GVI.h"
 #include "interventions/IRS.h"
@@ -43,6 +44,8 @@ vector<ContinuousHumanDeployment> InterventionManager::continuous;
 vector<unique_ptr<TimedDeployment>> InterventionManager::timed;
 uint32_t InterventionManager::nextTimed;
 OM::Host::ImportedInfections InterventionManager::importedInfections;
+bool InterventionManager::useFastSampling = false;
+util::BlockRng InterventionManager::deployRng(0, 0);
 
 // declared in HumanComponents.h:
 vector<ComponentId> removeAtIds[SubPopRemove::NUM];
@@ -52,6 +55,15 @@ vector<ComponentId> removeAtIds[SubPopRemove::NUM];
 void InterventionManager::init (const scnXml::Interventions& intervElt, Transmission::TransmissionModel& transmission){
     nextTimed = 0;
     
+    useFastSampling = util::ModelOptions::option( util::FAST_DEPLOYMENT_SAMPLING );
+    if( useFastSampling ){
+        // Only draw from the master RNG when enabled, so that other
+        // scenarios keep their random streams unchanged.
+        uint64_t seed = util::master_RNG.gen_seed();
+        uint64_t stream = util::master_RNG.gen_seed();
+        deployRng.seed( seed, stream );
+    }
+    
     if( intervElt.getChangeHS().present() ){
         const scnXml::ChangeHS& chs = intervElt.getChangeHS().get();
         if( chs.getTimedDeployment().size() > 0 ){
@@ -403,15 +415,30 @@ void InterventionManager::deploy(Population& population, Transmission::Transmiss
     }
     
     // deploy continuous interventions
-    for( Population::Iter it = population.begin(); it != population.end(); ++it ){
-        uint32_t nextCtsDist = it->getNextCtsDist();
-        // deploy continuous interventions
-        while( nextCtsDist < continuous.size() )
-        {
-            if( !continuous[nextCtsDist].filterAndDeploy( *it, population ) )
-                break;  // deployment (and all remaining) happens in the future
-            nextCtsDist = it->incrNextCtsDist();
+    // Humans reaching a target age now form one birth cohort. We take groups
+    // of deployments with equal target age, oldest first; since the
+    // population is ordered by date of birth (oldest first), humans are
+    // visited in population order and each human receives its deployments in
+    // list order (as when iterating over the whole population).
+    for( size_t groupEnd = continuous.size(); groupEnd > 0; ){
+        const SimTime deployAge = continuous[groupEnd - 1].targetAge();
+        size_t groupBegin = groupEnd - 1;
+        bool active = continuous[groupBegin].isActive();
+        while( groupBegin > 0 && continuous[groupBegin - 1].targetAge() == deployAge ){
+            groupBegin -= 1;
+            active = active || continuous[groupBegin].isActive();
+        }
+        if( active ){
+            auto cohort = population.birthCohort( sim::now() - deployAge );
+            for( Population::Iter it = cohort.first; it != cohort.second; ++it ){
+                for( size_t i = groupBegin; i < groupEnd; ++i ){
+                    if( continuous[i].isActive() ){
+                        continuous[i].filterAndDeploy( *it );
+                    }
+                }
+            }
         }
+        groupEnd = groupBegin;
     }
 }
 
@@ -24,6 +24,7 @@
 #include "interventions/Interfaces.hpp"
 #include "Host/ImportedInfections.h"
 #include "Transmission/TransmissionModel.h"
+#include "util/random.h"
 #include "schema/interventions.h"
 
 namespace OM {
@@ -50,6 +51,7 @@ public:
         // most members are only set from XML,
         // nextTimed varies but is re-set by loadFromCheckpoint
         importedInfections & stream;
+        deployRng.checkpoint( stream );
     }
 
     /** Call after loading a checkpoint, passing the intervention-period time.
@@ -82,6 +84,14 @@ public:
      * If textId is unknown, an xml_scenario_error is thrown. */
     static ComponentId getComponentId( const std::string textId );
     
+    /** True when the FAST_DEPLOYMENT_SAMPLING model option is enabled, in
+     * which case mass deployments sample recipients using deploymentRng(). */
+    inline static bool fastSampling(){ return useFastSampling; }
+    
+    /** RNG for population-level sampling of mass deployments. Only seeded
+     * (and only used) when fastSampling() is true. */
+    inline static util::BlockRng& deploymentRng(){ return deployRng; }
+    
 private:
     // Map of textual identifiers to numeric identifiers for components
     static std::map<std::string,ComponentId> identifierMap;
@@ -97,6 +107,9 @@ private:
     // imported infections are not really interventions, and handled by a separate class
     // (but are grouped here for convenience and due toassociation in schema)
     static OM::Host::ImportedInfections importedInfections;
+    
+    static bool useFastSampling;
+    static util::BlockRng deployRng;
 };
 
 } }
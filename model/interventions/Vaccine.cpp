@@ -138,16 +138,20 @@ PerEffectPerHumanVaccine::PerEffectPerHumanVaccine( LocalRng& rng, ComponentId i
 }
 
 double PerHumanVaccine::getFactor( Vaccine::Types type ) const{
-    double factor = 1.0;
+    if( factorsTime != sim::ts1() ) updateFactors();
+    return factors[type];
+}
+void PerHumanVaccine::updateFactors() const{
+    for( size_t type = 0; type < Vaccine::NumVaccineTypes; ++type ){
+        factors[type] = 1.0;
+    }
     for( EffectList::const_iterator effect = effects.begin(); effect != effects.end(); ++effect ){
-        if( VaccineComponent::getParams(effect->component).type == type ){
-            SimTime age = sim::ts1() - effect->timeLastDeployment;  // implies age 1 TS on first use
-            double decayFactor = VaccineComponent::getParams(effect->component)
-                .decayFunc->eval( age, effect->hetSample );
-            factor *= 1.0 - effect->initialEfficacy * decayFactor;
-        }
+        const VaccineComponent& params = VaccineComponent::getParams(effect->component);
+        SimTime age = sim::ts1() - effect->timeLastDeployment;  // implies age 1 TS on first use
+        double decayFactor = params.decayFunc->eval( age, effect->hetSample );
+        factors[params.type] *= 1.0 - effect->initialEfficacy * decayFactor;
     }
-    return factor;
+    factorsTime = sim::ts1();
 }
 
 bool PerHumanVaccine::possiblyVaccinate( Host::Human& human,
@@ -178,6 +182,7 @@ bool PerHumanVaccine::possiblyVaccinate( Host::Human& human,
     
     effect->numDosesAdministered = numDosesAdministered + 1;
     effect->timeLastDeployment = sim::nowOrTs1();
+    factorsTime = SimTime::never();
     
     return true;
 }
@@ -24,6 +24,7 @@
 #include "Global.h"
 #include <vector>
 
+class UnittestUtil;
 namespace scnXml{ class Monitoring; }
 namespace OM {
 namespace mon {
@@ -77,6 +78,8 @@ private:
      * individuals outside other bounds. */
     static std::vector<SimTime> upperBound;
     //END
+    
+    friend class ::UnittestUtil;
 };
 
 } }
@@ -31,6 +31,11 @@
 #include <vector>
 #include <map>
 #include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include <thread>
+#include <exception>
 #include <boost/format.hpp>
 #include <gzstream/gzstream.h>
 
@@ -50,6 +55,31 @@ namespace OM { namespace mon {
     streamoff streamOff;
     streampos streamStart;
     
+    /* Lines are formatted in ctsLine and collected in ctsBuffer, which is
+     * written to ctsOStream when the flush interval has passed (or the buffer
+     * is large), on checkpointing and at the end. streamOff includes buffered
+     * output, so it is tracked without querying the file. */
+    ostringstream ctsLine;
+    string ctsBuffer;
+    const size_t maxBufferSize = 1 << 20;
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point lastFlush;
+    
+    /* With a non-zero flush interval, flushed output is written by a
+     * background thread (so that a slow file system doesn't hold up the
+     * simulation), and its error (if any). At most one write is pending:
+     * flush() first waits for the previous one. ctsOStream is only used by
+     * the writer while it runs. */
+    std::thread ctsWriter;
+    std::exception_ptr ctsWriterError;
+    
+    void writeToFile (const string& data){
+        ctsOStream.write( data.data(), data.size() );
+        ctsOStream.flush();
+        if( ctsOStream.fail() )
+            throw util::base_exception( string("Continuous: cannot write ").append(cts_filename), util::Error::FileIO );
+    }
+    
     // List of all registered callbacks (not used after init() runs)
     class Callback {
     protected:
@@ -89,6 +119,13 @@ namespace OM { namespace mon {
     ContinuousType Continuous;
     
     ContinuousType::~ContinuousType (){
+        // Errors can't be reported from here; write what we can.
+        if( ctsWriter.joinable() )
+            ctsWriter.join();
+        if( !ctsBuffer.empty() && ctsOStream.is_open() ){
+            ctsOStream.write( ctsBuffer.data(), ctsBuffer.size() );
+            ctsOStream.flush();
+        }
         // free memory
         toReport.clear();
         for( auto it = registered.begin(); it != registered.end(); ++it )
@@ -122,6 +159,9 @@ namespace OM { namespace mon {
 	locale nfn_put_locale(old_locale, new boost::math::nonfinite_num_put<char>);
 	ctsOStream.imbue( nfn_put_locale );
 	ctsOStream.width (0);
+	ctsLine.imbue( nfn_put_locale );
+	ctsLine.width (0);
+	lastFlush = Clock::now();
 	
 	if( isCheckpoint ){
 	    scnXml::OptionSet::OptionSequence sOSeq = ctsOpt.get().getOption();
@@ -160,7 +200,7 @@ namespace OM { namespace mon {
 		    toReport.push_back( reg_it->second );
 		}
 	    }
-	    ctsOStream << mon::lineEnd << flush;
+	    ctsOStream << mon::lineEnd << std::flush;
 	    streamOff = ctsOStream.tellp() - streamStart;
 	}
     }
@@ -169,6 +209,9 @@ namespace OM { namespace mon {
         if( ctsPeriod == SimTime::zero() )
             return;	// output disabled
 	
+	// output before the checkpoint must be in the file
+	flush();
+	finishWrite();
 	streamOff & stream;
     }
     void ContinuousType::checkpoint (istream& stream){
@@ -183,6 +226,7 @@ namespace OM { namespace mon {
 	streamOff & stream;
 	// We skip back to the last write-point, so anything written after the
 	// last checkpoint will be repeated:
+	ctsBuffer.clear();
 	ctsOStream.seekp( streamOff, ios_base::beg );
 	
 	if( ctsOStream.fail() )
@@ -200,6 +244,12 @@ namespace OM { namespace mon {
         registered[optName] = new Callback2Pop( titles, outputCb );
     }
     
+    bool ContinuousType::isEnabled (const string& optName) const{
+        auto reg_it = registered.find( optName );
+        if( reg_it == registered.end() ) return false;
+        return find( toReport.begin(), toReport.end(), reg_it->second ) != toReport.end();
+    }
+    
     void ContinuousType::update (const Population& population){
         if( ctsPeriod == SimTime::zero() )
             return;	// output disabled
@@ -210,22 +260,63 @@ namespace OM { namespace mon {
         } else {
             if( mod_nn(sim::now(), ctsPeriod) != SimTime::zero() )
                 return;
-            ctsOStream << sim::now().inSteps() << '\t';
+            ctsLine << sim::now().inSteps() << '\t';
         }
 	
         if( duringInit && sim::intervTime() < SimTime::zero() ){
-            ctsOStream << "nan";
+            ctsLine << "nan";
         }else{
             // NOTE: we could switch this to output dates, but (1) it would be
             // breaking change and (2) it may be harder to use.
-            ctsOStream << sim::intervTime().inSteps();
+            ctsLine << sim::intervTime().inSteps();
         }
 	for( size_t i = 0; i < toReport.size(); ++i )
-	    toReport[i]->call( population, ctsOStream );
-	// We must flush often to avoid temporarily outputting partial lines
-	// (resulting in incorrect real-time graphs).
-	ctsOStream << mon::lineEnd << flush;
+	    toReport[i]->call( population, ctsLine );
+	ctsLine << mon::lineEnd;
 	
-	streamOff = ctsOStream.tellp() - streamStart;
+	// Only whole lines are written, so real-time graphs never see partial
+	// lines; writing is delayed by up to the flush interval.
+	const string line = ctsLine.str();
+	ctsLine.str( string() );
+	ctsBuffer.append( line );
+	streamOff += line.size();
+	const double interval = util::CommandLine::getCtsoutFlushInterval();
+	if( ctsBuffer.size() >= maxBufferSize || interval <= 0.0 ||
+	    std::chrono::duration<double>( Clock::now() - lastFlush ).count() >= interval )
+	{
+	    flush();
+	}
+    }
+    
+    void ContinuousType::flush (){
+        finishWrite();
+        lastFlush = Clock::now();
+        if( ctsBuffer.empty() || !ctsOStream.is_open() )
+            return;
+        
+        string data;
+        data.swap( ctsBuffer );
+        if( util::CommandLine::getCtsoutFlushInterval() > 0.0 ){
+            // Note: the string is moved into the thread's copy of its arguments.
+            ctsWriter = std::thread( [] (const string& data) {
+                    try {
+                        writeToFile (data);
+                    } catch (...) {
+                        ctsWriterError = std::current_exception();
+                    }
+                }, std::move(data) );
+        } else {
+            writeToFile (data);
+        }
+    }
+    
+    void ContinuousType::finishWrite (){
+        if( ctsWriter.joinable() )
+            ctsWriter.join();
+        if( ctsWriterError ){
+            std::exception_ptr e = ctsWriterError;
+            ctsWriterError = nullptr;
+            std::rethrow_exception( e );
+        }
     }
 } }
@@ -72,10 +72,22 @@ namespace mon {
         /// As above, except that the called delegate is passed a reference to the Population object
         void registerCallback (string optName, string titles, fastdelegate::FastDelegate2<const Population&, ostream&>);
 	
+	/** Return true if the named output is enabled. Only valid after init()
+	 * (i.e. from within callbacks). */
+	bool isEnabled (const string& optName) const;
+	
 	/// Generate time-step's output. Called at beginning of time step.
         /// Passed population since some callbacks use this to generate output.
 	void update (const Population& population);
         
+        /** Write any buffered output to the file. With a non-zero flush
+         * interval (--ctsout-flush) this happens on a background thread. */
+        void flush ();
+        
+        /** Wait for output being written in the background (if any) and
+         * throw if writing it failed. */
+        void finishWrite ();
+        
     private:
         void checkpoint(ostream& stream);
         void checkpoint(istream& stream);
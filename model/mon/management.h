@@ -50,7 +50,8 @@ void initMainSim();
 /// Call after all data for some survey number has been provided
 void concludeSurvey();
 
-/// Write survey data to output.txt (or configured file)
+/// Write survey data to output.txt (or configured file). With streamed
+/// output this only writes the surveys not already written.
 void writeSurveyData();
 
 // Checkpointing
@@ -61,6 +62,20 @@ void checkpoint( std::istream& stream );
 namespace internal{
     // Write results to stream
     void write( std::ostream& stream );
+    // Write the file header (binary output only)
+    void writeHeader( std::ostream& stream );
+    // Write results of surveys numbered begin to end-1 (excluding IMR)
+    void writeSurveys( std::ostream& stream, size_t begin, size_t end );
+    // Write the special IMR output, if enabled
+    void writeIMR( std::ostream& stream );
+    // Free memory used by surveys before end (streamed output only)
+    void releaseSurveys( size_t end );
+    // Add reports accumulated by chunks (see setReportChunk()) to the stores
+    void mergeReportChunks();
+    
+    // Checkpointing of streamed output
+    void checkpointOutput( std::ostream& stream );
+    void checkpointOutput( std::istream& stream );
     
     /** Get the output cohort set numeric identifier given the internal one
      * (as returned by Survey::updateCohortSet()). */
@@ -32,9 +32,13 @@
 #include "schema/monitoring.h"
 
 #include "WithinHost/Diagnostic.h"
+#include "Clinical/ClinicalModel.h"
 
 #include <gzstream/gzstream.h>
+#include <zlib.h>
 #include <fstream>
+#include <sstream>
+#include <cstring>
 #include <boost/algorithm/string.hpp>
 
 namespace OM {
@@ -163,18 +167,25 @@ void updateSurveyNumbers() {
         impl::nextSurveyDate = nextSurvey.date;
     }
 }
-void initMainSim(){
-    impl::surveyIndex = 0;
-    impl::isInit = true;
-    updateSurveyNumbers();
+// ———  streamed output  ———
+
+// With the STREAM_OUTPUT command-line option, each reported survey is written
+// once no further reports can arrive for it, and its memory released.
+namespace impl {
+    size_t writeIndex = 0;      // index in surveyDates of next survey to check for writing
+    size_t nWritten = 0;        // number of reported surveys written
 }
-void concludeSurvey(){
-    updateConditions();
-    impl::surveyIndex += 1;
-    updateSurveyNumbers();
+fstream surveyOStream;
+/* Record last position in file (as position minus start), for checkpointing;
+ * as in Continuous. */
+streamoff surveyStreamOff = 0;
+streampos surveyStreamStart;
+
+inline bool streamOutput(){
+    return util::CommandLine::option( util::CommandLine::STREAM_OUTPUT );
 }
 
-void writeToStream(ostream& stream) {
+void setupStream(ostream& stream) {
     // This locale ensures uniform formatting of nans and infs on all platforms.
     std::locale old_locale;
     std::locale nfn_put_locale(old_locale, new boost::math::nonfinite_num_put<char>);
@@ -184,12 +195,145 @@ void writeToStream(ostream& stream) {
     // For additional control:
     // stream.precision (6);
     // stream << scientific;
+}
+
+string surveyFileName(){
+    string filename = util::CommandLine::getOutputName();
+    if (util::CommandLine::option( util::CommandLine::COMPRESS_OUTPUT ))
+        filename.append(".gz");
+    return filename;
+}
+
+void openSurveyStream( bool resume ){
+    string filename = surveyFileName();
+    if( resume ){
+        // Resume writing at the position recorded in the checkpoint.
+        // Anything written after the checkpoint is written again.
+        surveyOStream.open( filename.c_str(), ios::binary|ios::in|ios::out );
+        if( surveyOStream.fail() )
+            throw util::checkpoint_error( "mon: resume error (no output file)" );
+        surveyOStream.seekp( 0, ios_base::beg );
+        surveyStreamStart = surveyOStream.tellp();
+        surveyOStream.seekp( surveyStreamOff, ios_base::beg );
+        if( surveyOStream.fail() )
+            throw util::checkpoint_error( "mon: resume error (bad pos/file)" );
+    }else{
+        surveyOStream.open( filename.c_str(), ios::binary|ios::out|ios::trunc );
+        if( surveyOStream.fail() )
+            throw util::base_exception( "mon: unable to open output file" );
+        surveyStreamStart = surveyOStream.tellp();
+        surveyStreamOff = 0;
+    }
+}
+
+/* Append data to the output file. With compression, each block is written as
+ * a separate gzip member; a concatenation of members is a valid gzip file. */
+void appendSurveyOutput( const string& data ){
+    if( data.empty() ) return;
+    if( util::CommandLine::option( util::CommandLine::COMPRESS_OUTPUT ) ){
+        z_stream zs;
+        memset( &zs, 0, sizeof(zs) );
+        // windowBits 15 + 16 selects a gzip header
+        if( deflateInit2( &zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                          Z_DEFAULT_STRATEGY ) != Z_OK )
+            throw util::base_exception( "mon: unable to initialise output compression" );
+        vector<char> buf( deflateBound( &zs, data.size() ) );
+        zs.next_in = reinterpret_cast<Bytef*>( const_cast<char*>( data.data() ) );
+        zs.avail_in = data.size();
+        zs.next_out = reinterpret_cast<Bytef*>( buf.data() );
+        zs.avail_out = buf.size();
+        int ret = deflate( &zs, Z_FINISH );
+        size_t len = buf.size() - zs.avail_out;
+        deflateEnd( &zs );
+        if( ret != Z_STREAM_END )
+            throw util::base_exception( "mon: output compression failed" );
+        surveyOStream.write( buf.data(), len );
+    }else{
+        surveyOStream.write( data.data(), data.size() );
+    }
+    surveyOStream.flush();
+    if( surveyOStream.fail() )
+        throw util::base_exception( "mon: error writing output file" );
+    surveyStreamOff = surveyOStream.tellp() - surveyStreamStart;
+}
+
+/* Write surveys for which no further reports can arrive. If final, write all
+ * remaining surveys and the IMR output.
+ * 
+ * Most reports go to the current survey. The exception is clinical episodes,
+ * reported to the survey during which they started once health-system memory
+ * has expired; Population::newSurvey() flushes expired episodes, so no
+ * further reports can arrive for surveys at least hsMemory ago. */
+void writeCompletedSurveys( bool final ){
+    const SimTime memory = Clinical::ClinicalModel::hsMemory();
+    size_t end = impl::nWritten;        // end of range of survey numbers to write
+    while( impl::writeIndex < impl::surveyIndex ){
+        const SurveyDate& survey = impl::surveyDates[impl::writeIndex];
+        if( !final && survey.date + memory > sim::intervDate() ) break;
+        if( survey.isReported() ) end = survey.num + 1;
+        impl::writeIndex += 1;
+    }
+    if( final ) end = impl::nSurveys;
+    if( end == impl::nWritten && !final ) return;
     
+    ostringstream chunk;
+    setupStream( chunk );
+    internal::writeSurveys( chunk, impl::nWritten, end );
+    if( final ) internal::writeIMR( chunk );
+    internal::releaseSurveys( end );
+    impl::nWritten = end;
+    appendSurveyOutput( chunk.str() );
+}
+
+void internal::checkpointOutput( ostream& stream ){
+    impl::writeIndex & stream;
+    impl::nWritten & stream;
+    surveyStreamOff & stream;
+}
+void internal::checkpointOutput( istream& stream ){
+    impl::writeIndex & stream;
+    impl::nWritten & stream;
+    surveyStreamOff & stream;
+    if( streamOutput() && impl::isInit ){
+        openSurveyStream( true );
+    }
+}
+
+void initMainSim(){
+    impl::surveyIndex = 0;
+    impl::isInit = true;
+    updateSurveyNumbers();
+    if( streamOutput() ){
+        impl::writeIndex = 0;
+        impl::nWritten = 0;
+        openSurveyStream( false );
+        ostringstream header;
+        internal::writeHeader( header );
+        appendSurveyOutput( header.str() );
+    }
+}
+void concludeSurvey(){
+    internal::mergeReportChunks();      // before evaluating conditions
+    updateConditions();
+    impl::surveyIndex += 1;
+    updateSurveyNumbers();
+    if( streamOutput() ) writeCompletedSurveys( false );
+}
+
+void writeToStream(ostream& stream) {
+    setupStream( stream );
     internal::write( stream );
 }
 
 void writeSurveyData ()
 {
+    internal::mergeReportChunks();
+    if( streamOutput() ){
+        writeCompletedSurveys( true );
+        surveyOStream.close();
+        return;
+    }
+    
     string filename = util::CommandLine::getOutputName();
     auto mode = std::ios::out | std::ios::binary;
     
@@ -28,6 +28,7 @@
 #include "Clinical/ClinicalModel.h"
 #include "Host/Human.h"
 #include "util/errors.h"
+#include "util/CommandLine.h"
 #include "schema/scenario.h"
 
 #include <typeinfo>
@@ -56,6 +57,8 @@ namespace impl {
     SimDate nextSurveyDate = SimDate::future();
     
     vector<Condition> conditions;
+    
+    size_t reportChunk = NO_REPORT_CHUNK;       // chunk selected by setReportChunk()
 }
 
 /// One of these is used for every output index, and is specific to a measure
@@ -76,14 +79,30 @@ struct MonIndex {
     // least one of Deploy::TIMED, Deploy::CTS, Deploy::TREAT.
     uint8_t deployMask;
     
+    // Strides of each category in the result array (see setStrides()).
+    size_t strideAge, strideCohort, strideSpecies, strideGenotype, strideDrug;
+    
     // Used to calculate next offset. This is max output of `index(...)` + 1.
     inline size_t size() const{
         return nAges * nCohorts * nSpecies * nGenotypes * nDrugs;
     }
+    
+    // Set strides from the numbers of categories. Categories are laid out
+    // with age outermost and drug innermost. Unused categories (count 1) get
+    // stride 0, so that any index passed for these maps to the same item.
+    void setStrides(){
+        strideDrug = nDrugs > 1 ? 1 : 0;
+        strideGenotype = nGenotypes > 1 ? nDrugs : 0;
+        strideSpecies = nSpecies > 1 ? nDrugs * nGenotypes : 0;
+        strideCohort = nCohorts > 1 ? nDrugs * nGenotypes * nSpecies : 0;
+        strideAge = nAges > 1 ? nDrugs * nGenotypes * nSpecies * nCohorts : 0;
+    }
+    
     // Get the index in the result array to store this data at
     // (age group, cohort, species, genotype, drug).
     // 
     // First index is `self.offset`, last is `self.offset + self.size() - 1`.
+    // Indices of used categories must be in range.
     size_t index( size_t a, size_t c, size_t sp, size_t g, size_t d ) const{
 #ifndef NDEBUG
         if( (nAges > 1 && a >= nAges) ||
@@ -98,16 +117,11 @@ struct MonIndex {
                 << "\ngenotype\t" << g << " of " << nGenotypes
                 << "\ndrug\t" << d << " of " << nDrugs
                 << endl;
+            assert( false );
         }
 #endif
-        // We use `a % nAges` etc. to enforce `a < nAges` and handle
-        // the case `nAges == 1` (i.e. classification is turned off).
-        return offset +
-            (d % nDrugs) + nDrugs *
-            ((g % nGenotypes) + nGenotypes *
-            ((sp % nSpecies) + nSpecies *
-            ((c % nCohorts) + nCohorts *
-            (a % nAges))));
+        return offset + a * strideAge + c * strideCohort + sp * strideSpecies
+            + g * strideGenotype + d * strideDrug;
     }
     
     // Write out some data from results.
@@ -165,8 +179,36 @@ struct MonIndex {
             } } }
         }
     }
+    
+    // Write out some data from results in binary format: a flat array of
+    // reported values, with categories ordered (cohort, age group, species,
+    // genotype, drug) from outermost to innermost.
+    // 
+    // Parameters are as for write().
+    template<typename T>
+    void writeBinary( ostream& stream, const vector<T>& results, size_t surveyStart ) const
+    {
+        assert(results.size() >= surveyStart + size());
+        size_t nAgeCats = nAges == 1 ? 1 : nAges - 1;
+        for( size_t cohortSet = 0; cohortSet < nCohorts; ++cohortSet ){
+        for( size_t ageGroup = 0; ageGroup < nAgeCats; ++ageGroup ){
+        for( size_t species = 0; species < nSpecies; ++species ){
+        for( size_t genotype = 0; genotype < nGenotypes; ++genotype ){
+        for( size_t drug = 0; drug < nDrugs; ++drug ){
+            T value = results[surveyStart + index(ageGroup, cohortSet, species, genotype, drug)];
+            stream.write( reinterpret_cast<const char*>(&value), sizeof(T) );
+        } } } } }
+    }
 };
 
+// Write a value to a binary output stream (native byte order)
+template<typename T>
+inline void writeBin( ostream& stream, T value ){
+    stream.write( reinterpret_cast<const char*>(&value), sizeof(T) );
+}
+// Binary output writes int values as 32-bit integers:
+static_assert( sizeof(int) == 4, "binary output requires a 32-bit int" );
+
 struct MonIndByMeasure{
     bool operator() (const MonIndex& i,const MonIndex& j) {
         if( i.measure != j.measure ) return i.measure < j.measure;
@@ -174,11 +216,30 @@ struct MonIndByMeasure{
     }
 } monIndByMeasure;
 
+/// Flattened form of a MonIndex for dispatching non-deployment reports: the
+/// index of an item is `offset + sum(category index × stride)`.
+struct ReportTarget {
+    size_t offset;
+    size_t strideAge, strideCohort, strideSpecies, strideGenotype, strideDrug;
+    
+    explicit ReportTarget( const MonIndex& ind ) :
+        offset( ind.offset ),
+        strideAge( ind.strideAge ), strideCohort( ind.strideCohort ),
+        strideSpecies( ind.strideSpecies ), strideGenotype( ind.strideGenotype ),
+        strideDrug( ind.strideDrug )
+    {}
+    
+    inline size_t index( size_t a, size_t c, size_t sp, size_t g, size_t d ) const{
+        return offset + a * strideAge + c * strideCohort + sp * strideSpecies
+            + g * strideGenotype + d * strideDrug;
+    }
+};
+
 // Store data of type T which is to be reported
 template<typename T>
 class Store{
 public:
-    Store() : surveySize(0) {}
+    Store() : surveySize(0), firstSurvey(0), nHeld(0) {}
     
 private:
     // This lists all enabled outputs, sorted by `measure` (first field, of
@@ -191,14 +252,70 @@ private:
     typedef pair<uint16_t, uint16_t> MeasureRange;
     vector<MeasureRange> measure_map;
     
+    // Dispatch table for report(): for each measure, the range in
+    // `report_targets` of outputs accepting non-deployment reports.
+    vector<MeasureRange> report_map;
+    vector<ReportTarget> report_targets;
+    
     // Number of indices in `reports` used by a single survey
     size_t surveySize;
+    // Number of the first survey held in `reports` and number of surveys
+    // held. Without streamed output, all surveys are held (0 and nSurveys);
+    // with it only the window of surveys not yet written.
+    size_t firstSurvey, nHeld;
     // These are the stored reports (multidimensional; size is `size()` and
-    // indices are `survey * surveySize + measures[m].index(...)` for some `m`).
+    // indices are `surveyOffset(survey) + measures[m].index(...)` for some `m`).
     vector<T> reports;
     
+    // Accumulated reports of one chunk for one survey (survey is NOT_USED
+    // when the entry is free; values are then zero).
+    struct Pending {
+        size_t survey;
+        vector<T> values;       // size surveySize, indexed like a survey in `reports`
+    };
+    // Accumulators by chunk (see setReportChunk()); only chunks used so far
+    // are allocated. Usually each holds entries for one or two surveys.
+    vector<vector<Pending>> chunks;
+    
     // get size of reports
-    inline size_t size(){ return surveySize * impl::nSurveys; }
+    inline size_t size(){ return surveySize * nHeld; }
+    
+    // Get the index of the first item of some survey in `reports`, extending
+    // the window of held surveys if required.
+    inline size_t surveyOffset( size_t survey ){
+        if( survey < firstSurvey ){
+            throw TRACED_EXCEPTION_DEFAULT( "mon: report for a survey already written" );
+        }
+        if( survey >= firstSurvey + nHeld ){
+            assert( survey < impl::nSurveys );
+            nHeld = survey + 1 - firstSurvey;
+            reports.resize( size(), 0 );
+        }
+        return (survey - firstSurvey) * surveySize;
+    }
+    
+    // Get the start of the array where reports for some survey accumulate:
+    // the accumulator of the selected chunk, if any, otherwise `reports`.
+    T* reportTarget( size_t survey ){
+        const size_t off = surveyOffset(survey);
+        const size_t chunk = impl::reportChunk;
+        if( chunk == NO_REPORT_CHUNK ) return &reports[off];
+        
+        assert( chunk < NUM_REPORT_CHUNKS );
+        if( chunk >= chunks.size() ) chunks.resize( chunk + 1 );
+        vector<Pending>& list = chunks[chunk];
+        Pending* unused = nullptr;
+        for( Pending& p : list ){
+            if( p.survey == survey ) return p.values.data();
+            if( p.survey == NOT_USED && unused == nullptr ) unused = &p;
+        }
+        if( unused == nullptr ){
+            list.push_back( Pending{ NOT_USED, vector<T>( surveySize, 0 ) } );
+            unused = &list.back();
+        }
+        unused->survey = survey;
+        return unused->values.data();
+    }
     
 public:
     // Set up ready to accept reports. The passed list includes all measures
@@ -225,6 +342,10 @@ public:
         
         sortEnabledMeasures();
         
+        // With streamed output, the window starts with one survey and grows as needed
+        nHeld = util::CommandLine::option( util::CommandLine::STREAM_OUTPUT ) ?
+            min( impl::nSurveys, size_t(1) ) : impl::nSurveys;
+        
         // Leave a few spare slots for potential conditions using variables not already reported:
         reports.reserve(size() + 12);
         reports.assign(size(), 0);
@@ -262,6 +383,8 @@ public:
         m.deployMask = om.method;
         measures.push_back(m);
         
+        assert( !hasPending() );
+        chunks.clear();     // sizes depend on surveySize
         sortEnabledMeasures();
         reports.resize(size(), 0);
     }
@@ -273,6 +396,7 @@ public:
         surveySize = 0;
         for( size_t i = 0; i < measures.size(); ++i ){
             measures[i].offset = surveySize;
+            measures[i].setStrides();
             surveySize += measures[i].size();
             
             Measure m = measures[i].measure;
@@ -282,6 +406,17 @@ public:
                 measure_map[m].first = i;
             measure_map[m].second = i + 1;
         }
+        
+        report_targets.clear();
+        report_map.assign(M_NUM, make_pair(0, 0));
+        for( size_t m = 0; m < M_NUM; ++m ){
+            report_map[m].first = report_targets.size();
+            for( size_t i = measure_map[m].first; i < measure_map[m].second; ++i ){
+                if( measures[i].deployMask == Deploy::NA )
+                    report_targets.push_back( ReportTarget( measures[i] ) );
+            }
+            report_map[m].second = report_targets.size();
+        }
     }
     
     // Take a reported value and either store it or forget it.
@@ -290,19 +425,14 @@ public:
                  uint32_t cohortSet, size_t species, size_t genotype, size_t drug )
     {
         if( survey == NOT_USED ) return; // pre-main-sim & unit tests we ignore all reports
-        assert(measure < measure_map.size());
-        for( size_t i = measure_map[measure].first, end = measure_map[measure].second;
-            i < end; ++i )
-        {
-            assert(i < measures.size());
-            const MonIndex& ind = measures[i];
-            assert(ind.measure == measure);
-            if( ind.deployMask != Deploy::NA ) continue;        // skip measures tracking deployments
-            
-            size_t index = survey * surveySize +
-                    ind.index(ageIndex, cohortSet, species, genotype, drug);
-            assert( index < reports.size() );
-            reports[index] += val;
+        assert(measure < report_map.size());
+        const MeasureRange range = report_map[measure];
+        if( range.first == range.second ) return;       // not recorded
+        T* target = reportTarget(survey);
+        for( size_t i = range.first; i < range.second; ++i ){
+            size_t index = report_targets[i].index(ageIndex, cohortSet, species, genotype, drug);
+            assert( index < surveySize );
+            target[index] += val;
         }
     }
     
@@ -325,10 +455,9 @@ public:
             if( (ind.deployMask & method) == Deploy::NA ) continue;
             assert( ind.nSpecies == 1 && ind.nGenotypes == 1 );     // never used for deployments
             
-            size_t index = survey * surveySize +
-                    ind.index(ageIndex, cohortSet, 0, 0, 0);
-            assert( index < reports.size() );
-            reports[index] += val;
+            size_t index = ind.index(ageIndex, cohortSet, 0, 0, 0);
+            assert( index < surveySize );
+            reportTarget(survey)[index] += val;
         }
     }
     
@@ -338,6 +467,7 @@ public:
     /// match some measure being recorded.
     T get_sum( Measure measure, uint8_t method, size_t survey ){
         assert( survey != NOT_USED );
+        assert( !hasPending() );
         // We use the first compatible measure
         assert(measure < measure_map.size());
         for( size_t i = measure_map[measure].first, end = measure_map[measure].second;
@@ -348,7 +478,7 @@ public:
             assert(ind.measure == measure);
             if( ind.deployMask != method ) continue;    // incompatible deployment mode: skip
             
-            const size_t off = survey * surveySize + ind.offset;
+            const size_t off = surveyOffset(survey) + ind.offset;
             T sum = 0;
             size_t end2 = off + ind.size();
             assert(end2 <= reports.size());
@@ -367,40 +497,121 @@ public:
         return measure_map[measure].second > measure_map[measure].first;
     }
     
-    // Write stored values to stream for some output measure, om
-    void write( ostream& stream, size_t survey, const OutMeasure& om ){
+    // Find the record of some output measure, om
+    const MonIndex& find( const OutMeasure& om ) const{
         assert(om.m < measure_map.size());
         for( size_t i = measure_map[om.m].first, end = measure_map[om.m].second;
             i < end; ++i )
         {
             assert(i < measures.size());
             if( measures[i].outMeasure == om.outId ){
-                measures[i].write( stream, survey + 1, om, reports, survey * surveySize );
-                return;
+                return measures[i];
             }
         }
-        assert(false && "measure not found in records");
+        throw TRACED_EXCEPTION_DEFAULT( "measure not found in records" );
+    }
+    
+    // Write stored values to stream for some output measure, om
+    void write( ostream& stream, size_t survey, const OutMeasure& om ){
+        const size_t off = surveyOffset(survey);
+        find(om).write( stream, survey + 1, om, reports, off );
+    }
+    // As write(), but in binary format
+    void writeBinary( ostream& stream, size_t survey, const OutMeasure& om ){
+        const size_t off = surveyOffset(survey);
+        find(om).writeBinary( stream, reports, off );
+    }
+    
+    // Add the accumulators of all chunks to `reports` (chunk 0 first) and
+    // reset them.
+    void mergeChunks(){
+        for( vector<Pending>& list : chunks ){
+            for( Pending& p : list ){
+                if( p.survey == NOT_USED ) continue;
+                const size_t off = surveyOffset(p.survey);
+                for( size_t i = 0; i < surveySize; ++i ){
+                    reports[off + i] += p.values[i];
+                }
+                std::fill( p.values.begin(), p.values.end(), 0 );
+                p.survey = NOT_USED;
+            }
+        }
+    }
+    // True if some chunk holds reports not yet merged
+    bool hasPending() const{
+        for( const vector<Pending>& list : chunks ){
+            for( const Pending& p : list ){
+                if( p.survey != NOT_USED ) return true;
+            }
+        }
+        return false;
+    }
+    
+    // Drop data of all surveys before `end` (which must have been written).
+    void release( size_t end ){
+        assert( end >= firstSurvey );
+        const size_t n = min( end - firstSurvey, nHeld );
+        reports.erase( reports.begin(), reports.begin() + n * surveySize );
+        nHeld -= n;
+        firstSurvey = end;
     }
     
     // Checkpointing
     void checkpoint( ostream& stream ){
-        reports.size() & stream;
-        foreach (T& y, reports) {
-            y & stream;
+        firstSurvey & stream;
+        reports & stream;
+        // Unmerged chunk accumulators are saved as they are (merging early
+        // would change the order of additions)
+        chunks.size() & stream;
+        for( vector<Pending>& list : chunks ){
+            size_t n = 0;
+            for( const Pending& p : list ) if( p.survey != NOT_USED ) n += 1;
+            n & stream;
+            for( Pending& p : list ){
+                if( p.survey == NOT_USED ) continue;
+                p.survey & stream;
+                p.values & stream;
+            }
         }
-        // reports is the only field which changes after initialisation
+        // these (and the window over reports) are the only fields which
+        // change after initialisation
     }
     void checkpoint( istream& stream ){
+        firstSurvey & stream;
         size_t l;
         l & stream;
+        if( surveySize > 0 ){
+            if( l % surveySize != 0 )
+                throw util::checkpoint_error( "mon::reports: invalid list size" );
+            if( util::CommandLine::option( util::CommandLine::STREAM_OUTPUT ) )
+                nHeld = l / surveySize;
+        }
         if( l != size() ){
             throw util::checkpoint_error( "mon::reports: invalid list size" );
         }
         reports.resize (l);
-        foreach (T& y, reports) {
-            y & stream;
+        util::checkpoint::bulk_read (reports.data(), l, stream);
+        
+        l & stream;
+        if( l > NUM_REPORT_CHUNKS )
+            throw util::checkpoint_error( "mon::reports: invalid number of chunks" );
+        chunks.clear();
+        chunks.resize( l );
+        for( vector<Pending>& list : chunks ){
+            size_t n;
+            n & stream;
+            util::checkpoint::validateListSize( n );
+            list.resize( n );
+            for( Pending& p : list ){
+                p.survey & stream;
+                p.values & stream;
+                if( p.survey < firstSurvey || p.survey >= impl::nSurveys ||
+                    p.values.size() != surveySize )
+                    throw util::checkpoint_error( "mon::reports: invalid chunk" );
+            }
         }
-        // reports is the only field which changes after initialisation
+        // these (and the window over reports) are the only fields which
+        // change after initialisation
     }
 };
 
@@ -557,6 +768,15 @@ size_t setupCondition( const string& measureName, double minValue,
     return impl::conditions.size() - 1;
 }
 
+void setReportChunk( size_t chunk ){
+    assert( chunk == NO_REPORT_CHUNK || chunk < NUM_REPORT_CHUNKS );
+    impl::reportChunk = chunk;
+}
+void internal::mergeReportChunks(){
+    storeI.mergeChunks();
+    storeF.mergeChunks();
+}
+
 void updateConditions() {
     foreach( Condition& cond, impl::conditions ){
         double val = cond.isDouble ?
@@ -570,13 +790,72 @@ bool checkCondition( size_t conditionKey ){
     return impl::conditions[conditionKey].value;
 }
 
-void internal::write( ostream& stream ){
-    for( size_t survey = 0; survey < impl::nSurveys; ++survey ){
+inline bool binaryOutput(){
+    return util::CommandLine::option( util::CommandLine::BINARY_OUTPUT );
+}
+
+/* Binary output format (native byte order; util/readOutput.py reads this):
+ * 
+ * Header:
+ *  char[8]     "OMOUTBIN"
+ *  uint32      0x01020304 (byte order mark)
+ *  uint32      format version (1)
+ *  uint32      number of surveys
+ *  uint32      number of cohort sets, followed by the output identifier
+ *              of each (uint32)
+ *  uint32      number of measures, followed for each by:
+ *      int32       output measure number
+ *      uint8       flags: 1 = by age group, 2 = by species, 4 = by drug,
+ *                  8 = values are double (otherwise int32)
+ *      uint32[5]   number of cohort sets, reported age groups, species,
+ *                  genotypes and drugs (1 where not categorised)
+ *  int32       output number of the IMR measure or -1 if not reported
+ * 
+ * Then for each survey, for each measure, the values as a flat array with
+ * categories in the order given above (cohort set outermost).
+ * 
+ * Finally, if IMR is reported, its value (double). */
+void internal::writeHeader( ostream& stream ){
+    if( !binaryOutput() ) return;
+    stream.write( "OMOUTBIN", 8 );
+    writeBin<uint32_t>( stream, 0x01020304 );
+    writeBin<uint32_t>( stream, 1 );
+    writeBin<uint32_t>( stream, impl::nSurveys );
+    writeBin<uint32_t>( stream, impl::nCohorts );
+    for( uint32_t cohortSet = 0; cohortSet < impl::nCohorts; ++cohortSet ){
+        writeBin<uint32_t>( stream, cohortSetOutputId( cohortSet ) );
+    }
+    uint32_t nMeasures = 0;
+    foreach( const OutMeasure& om, reportedMeasures ){
+        if( om.m < M_NUM ) nMeasures += 1;
+    }
+    writeBin<uint32_t>( stream, nMeasures );
+    foreach( const OutMeasure& om, reportedMeasures ){
+        if( om.m >= M_NUM ) continue;   // IMR; see below
+        const MonIndex& ind = om.isDouble ? storeF.find( om ) : storeI.find( om );
+        writeBin<int32_t>( stream, om.outId );
+        writeBin<uint8_t>( stream, (om.byAge ? 1 : 0) | (om.bySpecies ? 2 : 0) |
+            (om.byDrug ? 4 : 0) | (om.isDouble ? 8 : 0) );
+        writeBin<uint32_t>( stream, ind.nCohorts );
+        writeBin<uint32_t>( stream, ind.nAges == 1 ? 1 : ind.nAges - 1 );
+        writeBin<uint32_t>( stream, ind.nSpecies );
+        writeBin<uint32_t>( stream, ind.nGenotypes );
+        writeBin<uint32_t>( stream, ind.nDrugs );
+    }
+    writeBin<int32_t>( stream, reportIMR );
+}
+
+void internal::writeSurveys( ostream& stream, size_t begin, size_t end ){
+    const bool binary = binaryOutput();
+    for( size_t survey = begin; survey < end; ++survey ){
         foreach( const OutMeasure& om, reportedMeasures ){
             if( om.m >= M_NUM ){
                 // "Special" measures are not reported this way. The only such measure is IMR.
                 assert( om.m == M_ALL_CAUSE_IMR && reportIMR >= 0 );
                 continue;
+            } else if( binary ) {
+                if( om.isDouble ) storeF.writeBinary( stream, survey, om );
+                else storeI.writeBinary( stream, survey, om );
             } else if( om.isDouble ) {
                 storeF.write( stream, survey, om );
             } else {
@@ -584,7 +863,11 @@ void internal::write( ostream& stream ){
             }
         }
     }
-    if( reportIMR >= 0 ){
+}
+void internal::writeIMR( ostream& stream ){
+    if( reportIMR >= 0 && binaryOutput() ){
+        writeBin<double>( stream, Clinical::InfantMortality::allCause() );
+    }else if( reportIMR >= 0 ){
         // Infant mortality rate is a single number, therefore treated specially.
         // It is calculated across the entire intervention period and used in
         // model fitting.
@@ -592,6 +875,15 @@ void internal::write( ostream& stream ){
             << "\t" << Clinical::InfantMortality::allCause() << lineEnd;
     }
 }
+void internal::write( ostream& stream ){
+    writeHeader( stream );
+    writeSurveys( stream, 0, impl::nSurveys );
+    writeIMR( stream );
+}
+void internal::releaseSurveys( size_t end ){
+    storeI.release( end );
+    storeF.release( end );
+}
 
 // Report functions: each reports to all usable stores (i.e. correct data type
 // and where parameters don't have to be fabricated).
@@ -694,6 +986,7 @@ void checkpoint( ostream& stream ){
     
     storeI.checkpoint(stream);
     storeF.checkpoint(stream);
+    internal::checkpointOutput(stream);
 }
 void checkpoint( istream& stream ){
     impl::isInit & stream;
@@ -704,6 +997,7 @@ void checkpoint( istream& stream ){
     
     storeI.checkpoint(stream);
     storeF.checkpoint(stream);
+    internal::checkpointOutput(stream);
 }
 
 }
@@ -242,6 +242,24 @@ void reportStatMSGF( Measure measure, size_t species, size_t genotype, double va
 void reportStatMACSGF( Measure measure, size_t ageIndex, uint32_t cohortSet,
                   size_t species, size_t genotype, double val );
 
+/** Reports may be accumulated per chunk of the population.
+ * 
+ * While a chunk is selected, reports go to an accumulation buffer of that
+ * chunk instead of the shared store. Buffers are added to the store in chunk
+ * order (0 first) when a survey is concluded (before deployment conditions
+ * are evaluated) and before output is written, so that results do not
+ * depend on the order in which chunks are processed. */
+const size_t NUM_REPORT_CHUNKS = 16;
+
+/// Get the chunk for the human at position i in a population of size n.
+inline size_t reportChunk( size_t i, size_t n ){
+    return i * NUM_REPORT_CHUNKS / n;
+}
+const size_t NO_REPORT_CHUNK = static_cast<size_t>(-1);
+/// Select the chunk used by subsequent reports, or NO_REPORT_CHUNK to
+/// report to the shared store directly (the default).
+void setReportChunk( size_t chunk );
+
 /// Query whether an output measure is used.
 /// This function is not fast, so it is recommended to cache the result.
 bool isUsedM( Measure measure );
@@ -295,7 +295,7 @@ namespace OM { namespace util {
     // -----  AgeGroupInterpolator  -----
     
     AgeGroupInterpolator::AgeGroupInterpolator() :
-        obj(&AgeGroupDummy::singleton) {}
+        obj(&AgeGroupDummy::singleton), tableStepsPerYear(0.0) {}
     
     void AgeGroupInterpolator::set(
         const scnXml::AgeGroupValues& ageGroups, const char* eltName
@@ -310,6 +310,7 @@ namespace OM { namespace util {
         }else{
             throw util::xml_scenario_error( (boost::format( "age group interpolation %1% not implemented" ) %interp).str() );
         }
+        buildTable();
     }
     void AgeGroupInterpolator::reset(){
         assert( obj != nullptr );  // should not do that
@@ -317,6 +318,16 @@ namespace OM { namespace util {
             delete obj;
             obj = &AgeGroupDummy::singleton;
         }
+        table.clear();
+    }
+    void AgeGroupInterpolator::buildTable(){
+        table.clear();
+        if( SimTime::oneTS() <= SimTime::zero() ) return;       // time not initialised
+        tableStepsPerYear = static_cast<double>(sim::stepsPerYear());
+        const int steps = sim::maxHumanAge().inSteps() + 1;
+        table.reserve( steps );
+        for( int i = 0; i < steps; ++i )
+            table.push_back( obj->eval( SimTime::fromTS(i).inYears() ) );
     }
     bool AgeGroupInterpolator::isSet()    {
         return obj != &AgeGroupDummy::singleton;
@@ -47,8 +47,10 @@ protected:
 /** A class representing deterministic interpolation of data collected
  * according to age groups. Derived classes implement the actual interpolation.
  * 
- * Current version does not store an age index, thus an order log(n) lookup
- * must occur each time a value is looked up.
+ * Values at ages which are a whole number of time steps (as given by
+ * SimTime::inYears(), i.e. the ages of humans at the start or end of a step)
+ * are precomputed for ages up to sim::maxHumanAge(), so that these (the usual
+ * case) need only one array read. Other ages use an order log(n) lookup.
  ********************************************/
 struct AgeGroupInterpolator
 {
@@ -71,12 +73,17 @@ struct AgeGroupInterpolator
     
     /** Return a value interpolated for age ageYears. */
     inline double eval( double ageYears )const{
+        // Table entries are exactly obj->eval( SimTime::fromTS(i).inYears() )
+        const int i = static_cast<int>( ageYears * tableStepsPerYear + 0.5 );
+        if( static_cast<size_t>(i) < table.size() && SimTime::fromTS(i).inYears() == ageYears )
+            return table[i];
         return obj->eval( ageYears );
     }
     
     /** Scale function by factor. */
     inline void scale( double factor ){
         obj->scale( factor );
+        buildTable();
     }
 
     /** Find the youngest age which is the global maximum (i.e. the age at
@@ -87,7 +94,14 @@ struct AgeGroupInterpolator
     }
     
 private:
+    /// Fill table from obj (leaves it empty if time isn't initialised)
+    void buildTable();
+    
     AgeGroupInterpolation *obj;
+    /// Values by age in time steps, from 0 to sim::maxHumanAge() inclusive
+    vector<double> table;
+    /// Time steps per year as a double (for indexing table)
+    double tableStepsPerYear;
 };
 
 } }
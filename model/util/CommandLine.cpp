@@ -38,6 +38,9 @@ namespace OM { namespace util {
     string CommandLine::resourcePath;
     string CommandLine::outputName;
     string CommandLine::ctsoutName;
+    double CommandLine::ctsoutFlushInterval = 1.0;
+    string CommandLine::checkpointInterval;
+    double CommandLine::checkpointWalltime = 0.0;
     
     string parseNextArg (int argc, char* argv[], int& i) {
 	++i;
@@ -80,11 +83,28 @@ namespace OM { namespace util {
 		    outputName = parseNextArg (argc, argv, i);
                 } else if (clo == "compress-output") {
                     options.set (COMPRESS_OUTPUT);
+                } else if (clo == "stream-output") {
+                    options.set (STREAM_OUTPUT);
+                } else if (clo == "output-format") {
+                    string format = parseNextArg (argc, argv, i);
+                    if (format == "binary") {
+                        options.set (BINARY_OUTPUT);
+                    } else if (format != "text") {
+                        throw cmd_exception ("--output-format: expected text or binary");
+                    }
                 } else if (clo == "ctsout") {
                     if (ctsoutName != ""){
                         throw cmd_exception ("--ctsout argument may only be given once");
                     }
                     ctsoutName = parseNextArg (argc, argv, i);
+                } else if (clo == "ctsout-flush") {
+                    try {
+                        ctsoutFlushInterval = lexical_cast<double> (parseNextArg (argc, argv, i));
+                    } catch (const boost::bad_lexical_cast&) {
+                        throw cmd_exception ("--ctsout-flush: expected a number of seconds");
+                    }
+                    if (!(ctsoutFlushInterval >= 0.0))
+                        throw cmd_exception ("--ctsout-flush: may not be negative");
                 } else if (clo == "name") {
                     if (ctsoutName != "" || outputName != "" || scenarioFile != ""){
                         throw cmd_exception ("--name may not be used along with --scenario, --output or --ctsout");
@@ -120,6 +140,18 @@ namespace OM { namespace util {
                 } else if (clo == "checkpoint-stop") {
 		    options.set (CHECKPOINT);
                     options.set (CHECKPOINT_STOP);
+                } else if (clo == "checkpoint-async") {
+                    options.set (CHECKPOINT_ASYNC);
+                } else if (clo == "checkpoint-interval") {
+                    checkpointInterval = parseNextArg (argc, argv, i);
+                } else if (clo == "checkpoint-walltime") {
+                    try {
+                        checkpointWalltime = lexical_cast<double> (parseNextArg (argc, argv, i));
+                    } catch (const boost::bad_lexical_cast&) {
+                        throw cmd_exception ("--checkpoint-walltime: expected a number of seconds");
+                    }
+                    if (!(checkpointWalltime > 0.0))
+                        throw cmd_exception ("--checkpoint-walltime: must be positive");
                 } else if (clo == "debug-vector-fitting") {
                     options.set (DEBUG_VECTOR_FITTING);
 #	ifdef OM_STREAM_VALIDATOR
@@ -205,9 +237,20 @@ namespace OM { namespace util {
 	    << "			If path is relative (doesn't start '/'), --resource-path is used."<<endl
 	    << " -o --output file.txt	Uses file.txt as output file name. If not given, output.txt is used." << endl
 	    << "    --ctsout file.txt	Uses file.txt as ctsout file name. If not given, ctsout.txt is used." << endl
+	    << "    --ctsout-flush SECONDS" << endl
+	    << "			Write continuous output to the file at least this often" << endl
+	    << "			(default 1); it is buffered in between and written by a" << endl
+	    << "			background thread. 0 writes every line directly." << endl
 	    << " -n --name NAME		Equivalent to --scenario scenarioNAME.xml --output outputNAME.txt \\"<<endl
 	    << "			--ctsout ctsoutNAME.txt" <<endl
 	    << " -z --compress-output	Compress output with gzip (writes output.txt.gz)." << endl
+	    << "    --stream-output	Write each survey to the output file once no further reports" << endl
+	    << "			can arrive for it, instead of keeping all surveys in memory" << endl
+	    << "			until the end. Output is the same; with --compress-output" << endl
+	    << "			the file is a sequence of gzip members." << endl
+	    << "    --output-format FORMAT" << endl
+	    << "			Format of survey output: text (default) or binary, a compact" << endl
+	    << "			self-describing format (see util/readOutput.py for a reader)." << endl
 	    << "    --validate-only	Initialise and validate scenario, but don't run simulation." << endl
 	    << "    --deprecation-warnings" << endl
 	    << "			Warn about the use of features deemed error-prone and where" << endl
@@ -229,6 +272,18 @@ namespace OM { namespace util {
 	    << "			This may be used to skip redundant computation when multiple"<<endl
 	    << "			simulations differ only during the intervention phase."<<endl
 	    << "    --checkpoint-stop	Checkpoint as above, then stop immediately afterwards."<<endl
+	    << "    --checkpoint-async	Compress and write checkpoints in the background while the"<<endl
+	    << "			simulation continues. The \"checkpoint\" file is only updated"<<endl
+	    << "			once writing is complete."<<endl
+	    << "    --checkpoint-interval DURATION"<<endl
+	    << "			Also write a checkpoint every DURATION of simulated time"<<endl
+	    << "			during the main phase (e.g. 1y, 90d, 5t; default unit steps)."<<endl
+	    << "			DURATION must be a whole number of time steps."<<endl
+	    << "			Two files are used in rotation; a run resumes from the latest."<<endl
+	    << "    --checkpoint-walltime SECONDS"<<endl
+	    << "			Also write a checkpoint during the main phase at the first"<<endl
+	    << "			step boundary once SECONDS of real time have elapsed since"<<endl
+	    << "			the last one."<<endl
 	    << "    --debug-vector-fitting"<<endl
 	    << "			Show details of vector-parameter fitting. The fitting methods used" <<endl
 	    << "			aren't guaranteed to work. If they don't, this output should help"<<endl
@@ -61,6 +61,14 @@ namespace OM { namespace util {
             /** Print times of all surveys. */
             PRINT_SURVEY_TIMES,
             PRINT_GENOTYPES,
+            /** Write each survey to the output file as soon as it is
+             * complete instead of keeping all surveys in memory. */
+            STREAM_OUTPUT,
+            /** Write survey output in a binary format instead of text. */
+            BINARY_OUTPUT,
+            /** Compress and write checkpoints on a background thread while
+             * the simulation continues. */
+            CHECKPOINT_ASYNC,
 	    NUM_OPTIONS
 	};
 	
@@ -82,6 +90,25 @@ namespace OM { namespace util {
             return ctsoutName;
         }
         
+        /** Get the maximum time in seconds continuous output is held in
+         * memory before being written. */
+        static inline double getCtsoutFlushInterval (){
+            return ctsoutFlushInterval;
+        }
+        
+        /** Get the simulated-time interval between periodic checkpoints
+         * during the main phase, as given (not yet parsed since this
+         * requires the time step). Empty when not used. */
+        static inline string getCheckpointInterval (){
+            return checkpointInterval;
+        }
+        
+        /** Get the wall-clock interval in seconds between periodic
+         * checkpoints during the main phase; 0 when not used. */
+        static inline double getCheckpointWalltime (){
+            return checkpointWalltime;
+        }
+        
 	/** Looks through all command line options.
 	*
 	* @returns The name of the scenario XML file to use.
@@ -107,6 +134,9 @@ namespace OM { namespace util {
 	//Output filename (for main output file "output.txt")
 	static string outputName;
         static string ctsoutName;
+        static double ctsoutFlushInterval;
+        static string checkpointInterval;
+        static double checkpointWalltime;
     };
 } }
 #endif
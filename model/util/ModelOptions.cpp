@@ -76,6 +76,10 @@ namespace OM { namespace util {
             ignoreOptions.insert("PROPHYLACTIC_DRUG_ACTION_MODEL");
             codeMap["VIVAX_SIMPLE_MODEL"] = VIVAX_SIMPLE_MODEL;
             codeMap["INDIRECT_MORTALITY_FIX"] = INDIRECT_MORTALITY_FIX;
+            codeMap["FAST_DEPLOYMENT_SAMPLING"] = FAST_DEPLOYMENT_SAMPLING;
+            codeMap["LAZY_QUIESCENT_HUMANS"] = LAZY_QUIESCENT_HUMANS;
+            codeMap["COUNTER_BASED_HUMAN_RNG"] = COUNTER_BASED_HUMAN_RNG;
+            codeMap["BATCHED_DESCRIPTIVE_UPDATE"] = BATCHED_DESCRIPTIVE_UPDATE;
 	}
 	
 	OptionCodes operator[] (const string s) {
@@ -189,7 +193,8 @@ namespace OM { namespace util {
 	    .set(PARASITE_REPLICATION_GAMMA);
 	    
 	incompatibilities[NON_MALARIA_FEVERS]
-	    .set(MUELLER_PRESENTATION_MODEL);
+	    .set(MUELLER_PRESENTATION_MODEL)
+	    .set(LAZY_QUIESCENT_HUMANS);
 	
 	incompatibilities[TRANS_HET]
 	    .set(COMORB_TRANS_HET)	.set(TRANS_TREAT_HET)
@@ -219,6 +224,13 @@ namespace OM { namespace util {
             .set( MOLINEAUX_WITHIN_HOST_MODEL )
             .set( PENNY_WITHIN_HOST_MODEL );
         
+        incompatibilities[BATCHED_DESCRIPTIVE_UPDATE]
+            .set( DUMMY_WITHIN_HOST_MODEL )
+            .set( EMPIRICAL_WITHIN_HOST_MODEL )
+            .set( MOLINEAUX_WITHIN_HOST_MODEL )
+            .set( PENNY_WITHIN_HOST_MODEL )
+            .set( VIVAX_SIMPLE_MODEL );
+        
 	for(size_t i = 0; i < NUM_OPTIONS; ++i) {
 	    if (options [i] && (options & incompatibilities[i]).any()) {
 		ostringstream msg;
@@ -245,6 +257,8 @@ namespace OM { namespace util {
             options[IMMUNE_THRESHOLD_GAMMA] ||
             options[UPDATE_DENSITY_GAMMA] ) )
             throw xml_scenario_error( "Penny model option used without PENNY_WITHIN_HOST_MODEL option" );
+        if( options[BATCHED_DESCRIPTIVE_UPDATE] && !options[COUNTER_BASED_HUMAN_RNG] )
+            throw xml_scenario_error( "BATCHED_DESCRIPTIVE_UPDATE requires COUNTER_BASED_HUMAN_RNG" );
         
         if( SimTime::oneTS() == SimTime::fromDays(5) ){
             // 5 day TS is okay; some tests specific to this TS:
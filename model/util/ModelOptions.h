@@ -241,6 +241,56 @@ namespace OM { namespace util {
          */
         CFR_PF_USE_HOSPITAL,
         
+        /** Sample mass deployments (timed human deployments and imported
+         * infections) at the population level: selected humans are found by
+         * geometric skip-ahead using a deployment-level RNG instead of taking
+         * a Bernoulli sample from each human's own RNG.
+         * 
+         * This is much cheaper when coverage (or the import rate) is low, but
+         * uses a different random stream, so results differ from runs without
+         * this option (statistically equivalent, but not identical). */
+        FAST_DEPLOYMENT_SAMPLING,
+        
+        /** Skip the updates of quiescent humans while the EIR is zero.
+         * 
+         * A human older than one year with no infections, no drugs, no
+         * pending clinical events and no ITN is quiescent: while the EIR is
+         * zero, updating them only decays their immunity. Such humans are
+         * left untouched and caught up (with exactly the same immunity
+         * decay) when next needed: on EIR becoming non-zero, infection
+         * import, intervention deployment, surveys, sub-population expiry or
+         * death by age.
+         * 
+         * Skipped updates make no random draws from the human's own stream,
+         * so results differ from runs without this option (statistically
+         * equivalent, but not identical). Incompatible with
+         * NON_MALARIA_FEVERS (which can occur without parasites). */
+        LAZY_QUIESCENT_HUMANS,
+        
+        /** Counter-based random streams for humans.
+         * 
+         * Normally each human's generator is a single stream seeded from
+         * the master RNG, so the draws a human gets depend on all its
+         * earlier draws. With this option, each human gets a key from the
+         * master RNG on construction and its generator is re-seeded from
+         * (key, time step, phase) the first time it is used in each phase,
+         * where the phase is one of construction, between-step deployment
+         * or update. Draws in one step then don't depend on what happened
+         * in earlier steps nor on other humans, so results are independent
+         * of update order. Results differ from runs without this option. */
+        COUNTER_BASED_HUMAN_RNG,
+        
+        /** Determine the densities of all descriptive-model infections in
+         * the population in one batch per time step (see
+         * WithinHost::DescriptiveBatch) instead of host by host.
+         * 
+         * Density noise is drawn from a counter-based stream per infection
+         * and step instead of from the host's stream, so results differ from
+         * runs without this option (statistically equivalent, but not
+         * identical). Requires COUNTER_BASED_HUMAN_RNG and the descriptive
+         * within-host model. */
+        BATCHED_DESCRIPTIVE_UPDATE,
+        
 	// Used by tests; should be 1 more than largest option
 	NUM_OPTIONS,
         
@@ -24,6 +24,7 @@
 
 #include <limits>
 #include <sstream>
+#include <zlib.h>
 #include <assert.h>
 using namespace std;
 
@@ -205,6 +206,121 @@ namespace OM { namespace util { namespace checkpoint {
     }
     //@}
     
+    // bulk arrays
+    template<class T>
+    void bulk_write_impl (const T* x, size_t n, ostream& stream) {
+        stream.write (reinterpret_cast<const char*>(x), n * sizeof(T));
+    }
+    template<class T>
+    void bulk_read_impl (T* x, size_t n, istream& stream) {
+        streamsize len = n * sizeof(T);
+        stream.read (reinterpret_cast<char*>(x), len);
+        if (!stream || stream.gcount() != len)
+            throw checkpoint_error ("stream read error bulk");
+    }
+    void bulk_write (const int* x, size_t n, ostream& stream) {
+        bulk_write_impl (x, n, stream);
+    }
+    void bulk_read (int* x, size_t n, istream& stream) {
+        bulk_read_impl (x, n, stream);
+    }
+    void bulk_write (const double* x, size_t n, ostream& stream) {
+        bulk_write_impl (x, n, stream);
+    }
+    void bulk_read (double* x, size_t n, istream& stream) {
+        bulk_read_impl (x, n, stream);
+    }
+    
+    template<class T>
+    void vector_write (const vector<T>& x, ostream& stream) {
+        x.size() & stream;
+        bulk_write (x.data(), x.size(), stream);
+    }
+    template<class T>
+    void vector_read (vector<T>& x, istream& stream) {
+        size_t l;
+        l & stream;
+        validateListSize (l);
+        x.resize (l);
+        bulk_read (x.data(), l, stream);
+    }
+    void operator& (vector<int>& x, ostream& stream) {
+        vector_write (x, stream);
+    }
+    void operator& (vector<int>& x, istream& stream) {
+        vector_read (x, stream);
+    }
+    void operator& (vector<double>& x, ostream& stream) {
+        vector_write (x, stream);
+    }
+    void operator& (vector<double>& x, istream& stream) {
+        vector_read (x, stream);
+    }
+    
+    // compressed files
+    
+    /* Size of blocks passed to zlib. Much larger than the gzstream buffer,
+     * which is what makes this faster: zlib is called a few times per
+     * checkpoint instead of once per few hundred bytes. */
+    const size_t COMPRESS_BLOCK = 1 << 20;
+    
+    void writeFile (const string& data, const string& name) {
+        gzFile file = gzopen (name.c_str(), "wb");
+        if (file == nullptr)
+            throw checkpoint_error ("unable to open file for writing: " + name);
+        gzbuffer (file, COMPRESS_BLOCK);
+        for (size_t pos = 0; pos < data.size(); pos += COMPRESS_BLOCK) {
+            unsigned len = min (COMPRESS_BLOCK, data.size() - pos);
+            if (gzwrite (file, data.data() + pos, len) != int(len)) {
+                gzclose (file);
+                throw checkpoint_error ("error writing file: " + name);
+            }
+        }
+        if (gzclose (file) != Z_OK)
+            throw checkpoint_error ("error writing file: " + name);
+    }
+    void readFile (const string& name, string& data) {
+        gzFile file = gzopen (name.c_str(), "rb");
+        if (file == nullptr)
+            throw checkpoint_error ("unable to read file: " + name);
+        gzbuffer (file, COMPRESS_BLOCK);
+        data.clear ();
+        size_t pos = 0;
+        while (true) {
+            data.resize (pos + COMPRESS_BLOCK);
+            int n = gzread (file, &data[pos], COMPRESS_BLOCK);
+            if (n < 0) {
+                gzclose (file);
+                throw checkpoint_error ("error reading file: " + name);
+            }
+            pos += n;
+            if (size_t(n) < COMPRESS_BLOCK) break;
+        }
+        data.resize (pos);
+        gzclose (file);
+    }
+    
+    MemoryBuf::pos_type MemoryBuf::seekoff (off_type off,
+            ios_base::seekdir dir, ios_base::openmode which)
+    {
+        if (!(which & ios_base::in) || (which & ios_base::out))
+            return pos_type(off_type(-1));
+        char* base;
+        if (dir == ios_base::beg) base = eback();
+        else if (dir == ios_base::cur) base = gptr();
+        else base = egptr();
+        char* target = base + off;
+        if (target < eback() || target > egptr())
+            return pos_type(off_type(-1));
+        setg (eback(), target, egptr());
+        return pos_type(target - eback());
+    }
+    MemoryBuf::pos_type MemoryBuf::seekpos (pos_type pos,
+            ios_base::openmode which)
+    {
+        return seekoff (off_type(pos), ios_base::beg, which);
+    }
+    
     // string
     void operator& (string x, ostream& stream) {
         x.length() & stream;
@@ -279,7 +395,7 @@ namespace OM { namespace util { namespace checkpoint {
         }
     }
 
-    void operator& (const map<interventions::ComponentId,SimTime>& x, ostream& stream) {
+    void operator& (const vector<pair<interventions::ComponentId,SimTime>>& x, ostream& stream) {
         x.size() & stream;
         for(auto pos = x.begin (); pos != x.end() ; ++pos) {
             pos->first & stream;
@@ -287,17 +403,17 @@ namespace OM { namespace util { namespace checkpoint {
             t & stream;
         }
     }
-    void operator& (map<interventions::ComponentId,SimTime>& x, istream& stream) {
+    void operator& (vector<pair<interventions::ComponentId,SimTime>>& x, istream& stream) {
         size_t l;
         l & stream;
         validateListSize (l);
         x.clear ();
-        auto pos = x.begin ();
+        x.reserve (l);
         for(size_t i = 0; i < l; ++i) {
             interventions::ComponentId s( stream );
             SimTime t;
             t & stream;
-            pos = x.insert (pos, make_pair (s,t));
+            x.push_back (make_pair (s,t));
         }
     }
 
@@ -146,6 +146,55 @@ namespace checkpoint {
     void operator& (long double& x, istream& stream);
     //@}
     
+    /** @brief Bulk binary checkpointing of contiguous arrays
+     *
+     * Reads or writes n elements with a single stream operation. The layout is
+     * identical to that of checkpointing each element in turn. */
+    //@{
+    void bulk_write (const int* x, size_t n, ostream& stream);
+    void bulk_read (int* x, size_t n, istream& stream);
+    void bulk_write (const double* x, size_t n, ostream& stream);
+    void bulk_read (double* x, size_t n, istream& stream);
+    //@}
+    
+    /** @brief Operator& for vectors of POD types
+     *
+     * More specific than the generic vector<T> template (see
+     * checkpoint_containers.h) and using bulk reads/writes. Format is
+     * unchanged: the length followed by the elements. */
+    //@{
+    void operator& (vector<int>& x, ostream& stream);
+    void operator& (vector<int>& x, istream& stream);
+    void operator& (vector<double>& x, ostream& stream);
+    void operator& (vector<double>& x, istream& stream);
+    //@}
+    
+    /** @brief Compressed checkpoint files
+     *
+     * Checkpoints are serialised into memory and compressed in large blocks,
+     * rather than passing every field through a small compression-stream
+     * buffer. */
+    //@{
+    /** Compress data and write to the named file (gzip format). */
+    void writeFile (const string& data, const string& name);
+    /** Read and decompress the named file into data. */
+    void readFile (const string& name, string& data);
+    
+    /** An input stream buffer over an existing block of memory (not copied,
+     * not owned). Supports tellg() for error reporting. */
+    class MemoryBuf : public std::streambuf {
+    public:
+        MemoryBuf (char* begin, char* end) {
+            setg (begin, begin, end);
+        }
+    protected:
+        virtual pos_type seekoff (off_type off, ios_base::seekdir dir,
+                ios_base::openmode which = ios_base::in);
+        virtual pos_type seekpos (pos_type pos,
+                ios_base::openmode which = ios_base::in);
+    };
+    //@}
+    
     /** @brief Operator& for pointers
      *
      * These could be implemented for pointers but require reading objects in the opposite order to
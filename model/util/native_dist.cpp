@@ -0,0 +1,46 @@
+/* This file is part of OpenMalaria.
+ * 
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ * 
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "util/native_dist.hpp"
+
+namespace OM { namespace util { namespace native {
+
+// Constants for 128 layers, from Doornik (2005)
+const double ZigguratTables::R = 3.442619855899;
+/// Area of each layer
+static const double ZIGGURAT_V = 9.91256303526217e-3;
+
+ZigguratTables::ZigguratTables() {
+    double f = std::exp(-0.5 * R * R);
+    x[0] = ZIGGURAT_V / f;      // base layer: rectangle plus tail
+    x[1] = R;
+    x[LAYERS] = 0.0;
+    for (size_t i = 2; i < LAYERS; ++i) {
+        x[i] = std::sqrt(-2.0 * std::log(ZIGGURAT_V / x[i-1] + f));
+        f = std::exp(-0.5 * x[i] * x[i]);
+    }
+    for (size_t i = 0; i < LAYERS; ++i) {
+        r[i] = x[i+1] / x[i];
+    }
+}
+
+const ZigguratTables zigguratTables;
+
+} } }
@@ -0,0 +1,184 @@
+/* This file is part of OpenMalaria.
+ *
+ * Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ * Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ *
+ * OpenMalaria is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OM_util_native_dist
+#define OM_util_native_dist
+
+/* Native samplers for non-uniform distributions.
+ *
+ * These work directly on a generator G (Xoshiro256P or ChaCha) providing
+ * gen_u64() and gen_double(), so that each draw can be inlined instead of
+ * going through GSL's function-pointer callbacks. They are used by RNG when
+ * compiled with OM_RANDOM_USE_NATIVE_DIST (cmake option OM_NATIVE_SAMPLERS).
+ * GSL remains the reference: samples follow the same distributions but are
+ * not the same numbers, so results change with this option.
+ *
+ * Algorithms:
+ *
+ * -    normal: ziggurat with 128 layers (Doornik 2005, "An Improved Ziggurat
+ *      Method to Generate Normal Random Samples"), one 64-bit draw per
+ *      accepted sample in ~99% of cases
+ * -    gamma: Marsaglia & Tsang (2000), as in GSL
+ * -    Poisson: multiplication of uniforms for lambda < 10, otherwise PTRS
+ *      (Hörmann 1993, "The transformed rejection method for generating
+ *      Poisson random variables")
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+
+namespace OM { namespace util { namespace native {
+
+/// Layer boundaries of the normal ziggurat (see native_dist.cpp)
+struct ZigguratTables {
+    enum { LAYERS = 128 };
+    ZigguratTables();
+
+    /// x[i] is the right edge of layer i; x[0] is that of the base layer
+    /// (area equal to the other layers, including the tail)
+    double x[LAYERS + 1];
+    /// r[i] = x[i+1] / x[i]: within this, samples of layer i are accepted
+    double r[LAYERS];
+    /// Start of the tail
+    static const double R;
+};
+extern const ZigguratTables zigguratTables;
+
+/// 2^-53
+const double DOUBLE_EPS_53 = 1.1102230246251565e-16;
+
+/// Uniform sample in the open interval (0,1)
+template<class G>
+inline double uniform_pos(G& g) {
+    return ((g.gen_u64() >> 11) + 0.5) * DOUBLE_EPS_53;
+}
+
+/// Sample from the normal tail beyond R (mirrored if negative)
+template<class G>
+double normal_tail(G& g, bool negative) {
+    const double R = ZigguratTables::R;
+    double x, y;
+    do {
+        x = std::log(uniform_pos(g)) / R;
+        y = std::log(uniform_pos(g));
+    } while (-2.0 * y < x * x);
+    return negative ? x - R : R - x;
+}
+
+/// Sample from N(0,1)
+template<class G>
+inline double std_normal(G& g) {
+    const ZigguratTables& z = zigguratTables;
+    for (;;) {
+        const uint64_t bits = g.gen_u64();
+        // High 53 bits give u in [-1,1); bits 4-10 select the layer (the
+        // lowest bits of Xoshiro256+ are weak and not used).
+        const double u = 2.0 * ((bits >> 11) * DOUBLE_EPS_53) - 1.0;
+        const size_t i = (bits >> 4) & (ZigguratTables::LAYERS - 1);
+        if (std::fabs(u) < z.r[i]) return u * z.x[i];
+        if (i == 0) return normal_tail(g, u < 0.0);
+
+        // wedge: accept against the density between the layer edges
+        const double x = u * z.x[i];
+        const double f0 = std::exp(-0.5 * (z.x[i] * z.x[i] - x * x));
+        const double f1 = std::exp(-0.5 * (z.x[i+1] * z.x[i+1] - x * x));
+        if (f1 + g.gen_double() * (f0 - f1) < 1.0) return x;
+    }
+}
+
+/// Sample from the gamma distribution with shape a and scale b
+template<class G>
+double gamma(G& g, double a, double b) {
+    if (a < 1.0) {
+        // Gamma(a) = Gamma(a+1) * U^(1/a)
+        const double u = uniform_pos(g);
+        return gamma(g, 1.0 + a, b) * std::pow(u, 1.0 / a);
+    }
+
+    const double d = a - 1.0 / 3.0;
+    const double c = (1.0 / 3.0) / std::sqrt(d);
+    for (;;) {
+        double x, v;
+        do {
+            x = std_normal(g);
+            v = 1.0 + c * x;
+        } while (v <= 0.0);
+        v = v * v * v;
+        const double u = uniform_pos(g);
+        const double x2 = x * x;
+        if (u < 1.0 - 0.0331 * x2 * x2) return b * d * v;
+        if (std::log(u) < 0.5 * x2 + d * (1.0 - v + std::log(v))) return b * d * v;
+    }
+}
+
+/// Sample from the Poisson distribution with mean lambda (lambda ≥ 0)
+template<class G>
+int poisson(G& g, double lambda) {
+    if (lambda <= 0.0) return 0;
+
+    if (lambda < 10.0) {
+        // count uniforms until their product drops below exp(-lambda)
+        const double enlam = std::exp(-lambda);
+        int k = 0;
+        double prod = g.gen_double();
+        while (prod > enlam) {
+            k += 1;
+            prod *= g.gen_double();
+        }
+        return k;
+    }
+
+    // PTRS: transformed rejection with squeeze
+    const double slam = std::sqrt(lambda);
+    const double loglam = std::log(lambda);
+    const double b = 0.931 + 2.53 * slam;
+    const double a = -0.059 + 0.02483 * b;
+    const double invalpha = 1.1239 + 1.1328 / (b - 3.4);
+    const double vr = 0.9277 - 3.6224 / (b - 2.0);
+    for (;;) {
+        const double U = g.gen_double() - 0.5;
+        const double V = uniform_pos(g);
+        const double us = 0.5 - std::fabs(U);
+        const double k = std::floor((2.0 * a / us + b) * U + lambda + 0.43);
+        if (us >= 0.07 && V <= vr) return static_cast<int>(k);
+        if (k < 0.0 || (us < 0.013 && V > us)) continue;
+        if (std::log(V) + std::log(invalpha) - std::log(a / (us * us) + b)
+                <= -lambda + k * loglam - std::lgamma(k + 1.0))
+            return static_cast<int>(k);
+    }
+}
+
+/// Sample from the beta distribution (via two gamma samples)
+template<class G>
+inline double beta(G& g, double a, double b) {
+    const double x = gamma(g, a, 1.0);
+    const double y = gamma(g, b, 1.0);
+    return x / (x + y);
+}
+
+/// Sample from the Weibull distribution with scale lambda and shape k
+template<class G>
+inline double weibull(G& g, double lambda, double k) {
+    return lambda * std::pow(-std::log(uniform_pos(g)), 1.0 / k);
+}
+
+} } }
+#endif
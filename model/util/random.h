@@ -39,6 +39,13 @@
 // Unfortunately the authors do not support reproducibility of results.
 // #define OM_RANDOM_USE_BOOST_DIST
 
+// Native samplers (see util/native_dist.hpp) for the normal, log-normal,
+// gamma, beta, Poisson and Weibull distributions, inlined over our generators
+// instead of called through GSL. Samples follow the same distributions but are
+// different numbers, so results change. Enabled by cmake option
+// OM_NATIVE_SAMPLERS.
+// #define OM_RANDOM_USE_NATIVE_DIST
+
 #include "Global.h"
 #include "util/errors.h"
 #include <set>
@@ -61,7 +68,12 @@
 #include <gsl/gsl_randist.h>
 #endif
 
+#ifdef OM_RANDOM_USE_NATIVE_DIST
+#include "util/native_dist.hpp"
+#endif
+
 #include <cmath>
+#include <limits>
 
 namespace OM { namespace util {
 
@@ -92,6 +104,16 @@ gsl_rng_type make_gsl_rng_type(T& rng) {
     };
 }
 
+/** Geometric sample (see RNG::geometric_skip) by inversion of a sample u
+ * in [0,1). Requires 0 < prob < 1. */
+inline uint64_t geometric_skip_inv (double u, double prob) {
+    // 1 - u is in (0,1] so the log is finite
+    double skip = std::floor( std::log(1.0 - u) / std::log1p(-prob) );
+    if( skip >= static_cast<double>(std::numeric_limits<uint64_t>::max()) )
+        return std::numeric_limits<uint64_t>::max();
+    return static_cast<uint64_t>( skip );
+}
+
 /// Our random number generator.
 template<class T>
 struct RNG {
@@ -141,6 +163,14 @@ struct RNG {
         m_rng.seed(seed, stream);
     }
     
+    /** Start counter-based stream number counter of the given 128-bit key.
+     * 
+     * The result depends only on the inputs, not on any prior state (only
+     * available for LocalRng). */
+    void seed_counter(uint64_t key0, uint64_t key1, uint64_t counter) {
+        m_rng.seed_counter(key0, key1, counter);
+    }
+    
     /// Checkpointing
     /// 
     /// Note: this relies on the RNG having been constructed with the same seed.
@@ -163,12 +193,22 @@ struct RNG {
         return m_rng.gen_double();
     }
     
+    /** Fill out[0..n) with samples in the range [0,1).
+     * 
+     * Produces exactly what n calls to uniform_01() would (so results do not
+     * depend on whether this is used), but avoids per-call overhead. */
+    inline void fill_uniform_01 (double* out, size_t n) {
+        m_rng.fill_uniform(out, n);
+    }
+    
     /** This function returns a Gaussian random variate, with mean mean and
      * standard deviation std. The sampled value x ~ N(mean, std^2) . */
     double gauss (double mean, double std){
 # ifdef OM_RANDOM_USE_BOOST_DIST
         boost::random::normal_distribution<> dist (mean, std);
         return dist(m_rng);
+# elif defined OM_RANDOM_USE_NATIVE_DIST
+        return native::std_normal(m_rng)*std+mean;
 # else
         return gsl_ran_gaussian(&m_gsl_gen,std)+mean;
 # endif
@@ -179,6 +219,8 @@ struct RNG {
 # ifdef OM_RANDOM_USE_BOOST_DIST
         boost::random::gamma_distribution<> dist (a, b);
         return dist(m_rng);
+# elif defined OM_RANDOM_USE_NATIVE_DIST
+        return native::gamma(m_rng, a, b);
 # else
         return gsl_ran_gamma(&m_gsl_gen, a, b);
 # endif
@@ -196,6 +238,8 @@ struct RNG {
 # ifdef OM_RANDOM_USE_BOOST_DIST
         boost::random::lognormal_distribution<> dist (meanlog, stdlog);
         return dist (m_rng);
+# elif defined OM_RANDOM_USE_NATIVE_DIST
+        return exp(meanlog + stdlog * native::std_normal(m_rng));
 # else
         return gsl_ran_lognormal (&m_gsl_gen, meanlog, stdlog);
 # endif
@@ -238,6 +282,8 @@ struct RNG {
 # ifdef OM_RANDOM_USE_BOOST_DIST
         boost::random::beta_distribution<> dist (a, b);
         return dist(m_rng);
+# elif defined OM_RANDOM_USE_NATIVE_DIST
+        return native::beta(m_rng, a, b);
 # else
         return gsl_ran_beta (&m_gsl_gen,a,b);
 # endif
@@ -260,6 +306,8 @@ struct RNG {
 # ifdef OM_RANDOM_USE_BOOST_DIST
         boost::random::poisson_distribution<> dist (lambda);
         return dist(m_rng);
+# elif defined OM_RANDOM_USE_NATIVE_DIST
+        return native::poisson(m_rng, lambda);
 # else
         return gsl_ran_poisson (&m_gsl_gen, lambda);
 # endif
@@ -278,6 +326,19 @@ struct RNG {
 # endif
     }
     
+    /** Return the number of failures before the first success in a sequence
+     * of independent Bernoulli trials with success probability prob
+     * (geometric distribution on 0, 1, 2, ...).
+     * 
+     * Drawing this once per success allows skipping directly to the next
+     * selected member of a sequence instead of sampling bernoulli(prob) for
+     * each member. Requires 0 < prob <= 1. */
+    uint64_t geometric_skip(double prob){
+        assert( prob > 0.0 && prob <= 1.0 );
+        if( prob >= 1.0 ) return 0;
+        return geometric_skip_inv( uniform_01(), prob );
+    }
+    
     /** This function returns an integer from 0 to 1-n, where every value has
      * equal probability of being sampled. */
     inline int uniform (int n) {
@@ -297,6 +358,8 @@ struct RNG {
 # ifdef OM_RANDOM_USE_BOOST_DIST
         boost::random::weibull_distribution<> dist (k, lambda);
         return dist(m_rng);
+# elif defined OM_RANDOM_USE_NATIVE_DIST
+        return native::weibull(m_rng, lambda, k);
 # else
         return gsl_ran_weibull( &m_gsl_gen, lambda, k );
 # endif
@@ -316,6 +379,60 @@ private:
 typedef RNG<Xoshiro256P> LocalRng;
 typedef RNG<ChaCha<8>> MasterRng;
 
+/** A LocalRng for a single consumer drawing long runs of uniform samples
+ * (e.g. sampling recipients of a mass deployment).
+ * 
+ * Samples are generated a block at a time with RNG::fill_uniform_01(), so
+ * the sequence is exactly that of successive LocalRng::uniform_01() calls.
+ * Samples generated but not yet used are part of the state and are
+ * checkpointed. */
+class BlockRng {
+public:
+    BlockRng(uint64_t seed, uint64_t stream) :
+        m_rng(seed, stream), m_next(BLOCK) {}
+    
+    void seed(uint64_t seed, uint64_t stream) {
+        m_rng.seed(seed, stream);
+        m_next = BLOCK;
+    }
+    
+    void checkpoint(ostream& stream) {
+        m_rng.checkpoint(stream);
+        m_next & stream;
+        bulk_write(m_block + m_next, BLOCK - m_next, stream);
+    }
+    void checkpoint(istream& stream) {
+        m_rng.checkpoint(stream);
+        m_next & stream;
+        if( m_next > BLOCK )
+            throw checkpoint_error("BlockRng: bad buffer position");
+        bulk_read(m_block + m_next, BLOCK - m_next, stream);
+    }
+    
+    /** Generate a random number in the range [0,1). */
+    inline double uniform_01 () {
+        if( m_next == BLOCK ){
+            m_rng.fill_uniform_01(m_block, BLOCK);
+            m_next = 0;
+        }
+        return m_block[m_next++];
+    }
+    
+    /** As RNG::geometric_skip(). */
+    uint64_t geometric_skip(double prob){
+        assert( prob > 0.0 && prob <= 1.0 );
+        if( prob >= 1.0 ) return 0;
+        return geometric_skip_inv( uniform_01(), prob );
+    }
+    
+private:
+    static const uint32_t BLOCK = 256;
+    
+    LocalRng m_rng;
+    uint32_t m_next;    // index of next unused sample in m_block
+    double m_block[BLOCK];
+};
+
 /// The master RNG, used only for seeding local RNGs
 extern MasterRng master_RNG;
 
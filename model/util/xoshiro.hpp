@@ -28,6 +28,8 @@
 #include <cstdint>
 #include <limits>
 
+template<size_t R> class ChaCha;
+
 /// Implementation of Xoshiro256+
 class Xoshiro256P {
 public:
@@ -74,10 +76,35 @@ public:
         s[3] = source.gen_u64();
     }
 
+    /// Seed from a ChaCha generator: same state as the generic version
+    /// (four gen_u64() calls), but copies the eight words at once.
+    template<size_t R>
+    void seed(ChaCha<R>& source) {
+        uint32_t w[8];
+        source.fill(w, 8);
+        for (int i = 0; i < 4; ++i) {
+            s[i] = (uint64_t(w[2*i+1]) << 32) | w[2*i];
+        }
+    }
+
+    /// Counter-based seeding: the state is a hash (via SplitMix64) of a
+    /// 128-bit key and a counter, so that any (key, counter) stream can be
+    /// started directly, independently of other streams.
+    void seed_counter(uint64_t key0, uint64_t key1, uint64_t counter);
+
     uint64_t operator()();
     uint32_t gen_u32();
+    uint64_t gen_u64() {
+        return this->operator()();
+    }
     double gen_double();
 
+    /// Fill out[0..n) with uniform samples in [0,1).
+    /// 
+    /// Equivalent to n calls to gen_double() (identical output and final
+    /// state), but keeps the state in registers for the whole loop.
+    void fill_uniform(double* out, size_t n);
+
     friend bool operator==(const Xoshiro256P& lhs, const Xoshiro256P& rhs);
     friend bool operator!=(const Xoshiro256P& lhs, const Xoshiro256P& rhs);
 
@@ -121,6 +148,24 @@ static inline uint64_t rotl(const uint64_t x, int k) {
     return (x << k) | (x >> (64 - k));
 }
 
+static inline uint64_t splitmix64_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+inline void Xoshiro256P::seed_counter(uint64_t key0, uint64_t key1, uint64_t counter) {
+    const uint64_t golden = 0x9e3779b97f4a7c15ull;
+    uint64_t h = splitmix64_mix(key0 + golden);
+    h = splitmix64_mix((h ^ key1) + golden);
+    h = splitmix64_mix((h ^ counter) + golden);
+    // expand as a SplitMix64 sequence (never all zero in practice)
+    for (int i = 0; i < 4; ++i) {
+        h += golden;
+        s[i] = splitmix64_mix(h);
+    }
+}
+
 inline uint64_t Xoshiro256P::operator()() {
     const uint64_t result = s[0] + s[3];
 
@@ -151,6 +196,23 @@ inline double Xoshiro256P::gen_double() {
     return (x >> 11) * v;
 }
 
+inline void Xoshiro256P::fill_uniform(double* out, size_t n) {
+    const double v = 1.1102230246251565e-16; // = 0x1.0p-53
+    uint64_t s0 = s[0], s1 = s[1], s2 = s[2], s3 = s[3];
+    for (size_t i = 0; i < n; ++i) {
+        const uint64_t result = s0 + s3;
+        const uint64_t t = s1 << 17;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotl(s3, 45);
+        out[i] = (result >> 11) * v;
+    }
+    s[0] = s0; s[1] = s1; s[2] = s2; s[3] = s3;
+}
+
 
 // Implement <random> interface.
 inline bool operator==(const Xoshiro256P& lhs, const Xoshiro256P& rhs) {
@@ -38,6 +38,7 @@ import gzip
 
 sys.path[0]="@CMAKE_SOURCE_DIR@/util"
 import compareOutput
+import readOutput
 import compareCtsout
 import xml.sax.handler
 
@@ -146,6 +147,7 @@ def runScenario(options,omOptions,name):
     simDir = tempfile.mkdtemp(prefix=tmpprefix+'-', dir=testBuildDir)
     outputFile=os.path.join(simDir,"output.txt")
     outputGzFile=os.path.join(simDir,"output.txt.gz")
+    outputBinFile=os.path.join(simDir,"output.bin")
     ctsoutFile=os.path.join(simDir,"ctsout.txt")
     ctsoutGzFile=os.path.join(simDir,"ctsout.txt.gz")
     checkFile=os.path.join(simDir,"checkpoint")
@@ -159,8 +161,9 @@ def runScenario(options,omOptions,name):
         print(time.strftime("\033[0;33m%a, %d %b %Y %H:%M:%S")+"\t\033[1;33m%s" % scenarioSrc)
     
     startTime=lastTime=time.time()
-    # While no output.txt file and cmd exits successfully:
-    while (not os.path.isfile(outputFile)):
+    # With --checkpoint-stop, run until a run completes without writing a new
+    # checkpoint. (The output file may exist before the end when streamed.)
+    while True:
         if options.logging:
             print("\033[0;32m  "+(" ".join(cmd))+"\033[0;00m")
         ret=subprocess.call (cmd, shell=False, cwd=simDir)
@@ -168,24 +171,8 @@ def runScenario(options,omOptions,name):
             print("\033[1;31mNon-zero exit status: " + str(ret))
             break
         
-        # check for output.txt.gz in place of output.txt and uncompress:
-        if (os.path.isfile(outputGzFile)) and (not os.path.isfile(outputFile)):
-            f_in = gzip.open(outputGzFile, 'rb')
-            f_out = open(outputFile, 'wb')
-            f_out.writelines(f_in)
-            f_out.close()
-            f_in.close()
-            os.remove(outputGzFile)
-        
-        # check for ctsout.txt.gz in place of ctsout.txt and uncompress:
-        if (os.path.isfile(ctsoutGzFile)) and (not os.path.isfile(ctsoutFile)):
-            f_in = gzip.open(ctsoutGzFile, 'rb')
-            f_out = open(ctsoutFile, 'wb')
-            f_out.writelines(f_in)
-            f_out.close()
-            f_in.close()
-            os.remove(ctsoutGzFile)
-        
+        if "--checkpoint-stop" not in omOptions:
+            break
         # if the checkpoint file hasn't been updated, stop
         if not os.path.isfile(checkFile):
             break
@@ -194,6 +181,31 @@ def runScenario(options,omOptions,name):
             break
         lastTime=checkTime
     
+    # check for output.txt.gz in place of output.txt and uncompress:
+    if (os.path.isfile(outputGzFile)) and (not os.path.isfile(outputFile)):
+        f_in = gzip.open(outputGzFile, 'rb')
+        f_out = open(outputFile, 'wb')
+        f_out.writelines(f_in)
+        f_out.close()
+        f_in.close()
+        os.remove(outputGzFile)
+    
+    # convert binary output (--output-format binary) to text for comparison:
+    if os.path.isfile(outputFile) and readOutput.isBinaryOutput(outputFile):
+        os.rename(outputFile, outputBinFile)
+        readOutput.binaryToText(outputBinFile, outputFile)
+        if options.cleanup:
+            os.remove(outputBinFile)
+    
+    # check for ctsout.txt.gz in place of ctsout.txt and uncompress:
+    if (os.path.isfile(ctsoutGzFile)) and (not os.path.isfile(ctsoutFile)):
+        f_in = gzip.open(ctsoutGzFile, 'rb')
+        f_out = open(ctsoutFile, 'wb')
+        f_out.writelines(f_in)
+        f_out.close()
+        f_in.close()
+        os.remove(ctsoutGzFile)
+    
     if ret == 0 and options.logging:
         print("\033[0;33mDone in " + str(time.time()-startTime) + " seconds")
     
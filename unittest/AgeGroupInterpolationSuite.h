@@ -65,6 +65,19 @@ public:
         }
     }
     
+    void testPiecewiseConstTable () {
+        // ages at whole time steps use the table; results must agree exactly
+        agvElt->setInterpolation( "none" );
+        AgeGroupInterpolator o;
+        o.set( *agvElt, "testPiecewiseConstTable" );
+        for( int i = 0; i <= sim::maxHumanAge().inSteps(); ++i ){
+            double age = SimTime::fromTS(i).inYears();
+            size_t g = dataLen - 1;
+            while( stdLbounds[g] > age ) --g;
+            TS_ASSERT_EQUALS( o.eval( age ), stdValues[g] );
+        }
+    }
+    
     void testLinearInterp () {
         agvElt->setInterpolation( "linear" );
         AgeGroupInterpolator o;
@@ -174,6 +174,19 @@ public:
             TS_ASSERT_EQUALS(x, y);
         }
     }
+    
+    void testFill () {
+        ChaCha<8> rng1(0, 0), rng2(0, 0);
+        // start part-way into a block, then cross several block boundaries
+        rng1(); rng1(); rng1();
+        rng2(); rng2(); rng2();
+        uint32_t buf[50];
+        rng1.fill(buf, 50);
+        for (int n = 0; n < 50; n++) {
+            TS_ASSERT_EQUALS(buf[n], rng2());
+        }
+        TS_ASSERT(rng1 == rng2);
+    }
 };
 
 #endif
@@ -24,6 +24,7 @@
 
 #include <cxxtest/TestSuite.h>
 #include "util/checkpoint.h"
+#include "util/errors.h"
 #include <sstream>
 #include <limits>
 #include <climits>
@@ -55,6 +56,34 @@ public:
 	orig.assert_equals (*test);
     }
     
+    void testBulkVectors () {
+	vector<double> vd { 1.5, -0.0, 3e300, numeric_limits<double>::min() };
+	vector<int> vi { 7, -1, INT_MAX, INT_MIN, 0 };
+	ostringstream os (ios::out | ios::binary);
+	vd & os;
+	vi & os;
+	
+	// layout is that of the length followed by each element
+	ostringstream ref (ios::out | ios::binary);
+	vd.size() & ref;
+	for (double d : vd) d & ref;
+	vi.size() & ref;
+	for (int i : vi) i & ref;
+	TS_ASSERT_EQUALS (os.str(), ref.str());
+	
+	string data = os.str();
+	MemoryBuf buf (&data[0], &data[0] + data.size());
+	istream is (&buf);
+	vector<double> vd2;
+	vector<int> vi2;
+	vd2 & is;
+	TS_ASSERT_EQUALS (is.tellg(), streampos(sizeof(size_t) + vd.size() * sizeof(double)));
+	vi2 & is;
+	TS_ASSERT_EQUALS (vd, vd2);
+	TS_ASSERT_EQUALS (vi, vi2);
+	TS_ASSERT_THROWS (vi2 & is, OM::util::checkpoint_error);
+    }
+    
     struct TestObject {
 	TestObject () : x(-23263) {}
 	virtual ~TestObject () {}
@@ -0,0 +1,97 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2021 Swiss Tropical and Public Health Institute
+ Copyright (C) 2005-2015 Liverpool School Of Tropical Medicine
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#ifndef Hmod_LazyHumanSuite
+#define Hmod_LazyHumanSuite
+
+#include <cxxtest/TestSuite.h>
+#include "Host/Human.h"
+#include "UnittestUtil.h"
+#include "WHMock.h"
+
+using namespace OM;
+using UnitTest::WHMock;
+
+/** Tests sleeping, catch-up and waking of humans (LAZY_QUIESCENT_HUMANS). */
+class LazyHumanSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        UnittestUtil::initTime(5);
+        UnittestUtil::initAgeGroups();
+        human = UnittestUtil::createHuman( sim::nowOrTs0() - SimTime::fromYearsI(10) );
+        whm = dynamic_cast<WHMock*>(UnittestUtil::setHumanWH( *human,
+                unique_ptr<WithinHost::WHInterface>(new WHMock()) ));
+        ETS_ASSERT( whm != 0 );
+    }
+    void tearDown () {
+        human.reset();
+    }
+    
+    void testNotSleeping () {
+        TS_ASSERT( !human->isSleeping() );
+        UnittestUtil::incrTime( SimTime::fromTS(3) );
+        human->catchUp();
+        human->wake();
+        TS_ASSERT_EQUALS( whm->nCatchUpSteps, 0 );
+    }
+    
+    void testCatchUpStaysAsleep () {
+        human->sleep();
+        TS_ASSERT( human->isSleeping() );
+        
+        UnittestUtil::incrTime( SimTime::fromTS(3) );
+        human->catchUp();
+        TS_ASSERT_EQUALS( whm->nCatchUpSteps, 3 );
+        TS_ASSERT( human->isSleeping() );
+        
+        // repeated reads at the same time apply nothing more
+        human->catchUp();
+        TS_ASSERT_EQUALS( whm->nCatchUpSteps, 3 );
+        
+        // later catch-ups only apply steps not yet applied
+        UnittestUtil::incrTime( SimTime::fromTS(2) );
+        human->catchUp();
+        TS_ASSERT_EQUALS( whm->nCatchUpSteps, 5 );
+        TS_ASSERT( human->isSleeping() );
+    }
+    
+    void testWake () {
+        human->sleep();
+        UnittestUtil::incrTime( SimTime::fromTS(2) );
+        human->catchUp();
+        UnittestUtil::incrTime( SimTime::fromTS(4) );
+        human->wake();
+        // the total equals that of a single catch-up over the whole period
+        TS_ASSERT_EQUALS( whm->nCatchUpSteps, 6 );
+        TS_ASSERT( !human->isSleeping() );
+        
+        UnittestUtil::incrTime( SimTime::fromTS(1) );
+        human->wake();
+        TS_ASSERT_EQUALS( whm->nCatchUpSteps, 6 );
+    }
+    
+private:
+    unique_ptr<Host::Human> human;
+    WHMock* whm;
+};
+
+#endif
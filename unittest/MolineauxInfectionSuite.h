@@ -88,6 +88,30 @@ public:
         delete infection;
     }
     
+    void testVariantKernels(){
+        // The vectorised kernel must give identical results to the reference
+        UnittestUtil::MolineauxWHM_setup( "original", false );
+        LocalRng rng2( 0, 0 );
+        rng2.seed( 1095, 721347520444481703 );   // as m_rng
+        MolineauxInfection* ref = new MolineauxInfection (m_rng, 0xFFFFFFFF);
+        MolineauxInfection* vec = new MolineauxInfection (rng2, 0xFFFFFFFF);
+        bool useSIMD = MolineauxInfection::useSIMD;
+        bool extinct = false;
+        SimTime now = sim::ts0();
+        do{
+            MolineauxInfection::useSIMD = false;
+            extinct = ref->update(m_rng, 1.0, now, 71.43);
+            MolineauxInfection::useSIMD = true;
+            TS_ASSERT_EQUALS( vec->update(rng2, 1.0, now, 71.43), extinct );
+            TS_ASSERT_EQUALS( ref->getDensity(), vec->getDensity() );
+            TS_ASSERT_EQUALS( ref->nVariants, vec->nVariants );
+            now += SimTime::oneDay();
+        }while(!extinct);
+        MolineauxInfection::useSIMD = useSIMD;
+        delete ref;
+        delete vec;
+    }
+    
     void testMolOrig(){
         UnittestUtil::MolineauxWHM_setup( "original", false );
         MolInfStats stats( 200 );
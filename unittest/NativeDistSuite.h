@@ -0,0 +1,99 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2019 Swiss Tropical and Public Health Institute
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#ifndef Hmod_NativeDistSuite
+#define Hmod_NativeDistSuite
+
+#include <cxxtest/TestSuite.h>
+#include "util/xoshiro.hpp"
+#include "util/native_dist.hpp"
+
+using namespace OM::util;
+
+/** Checks the native samplers against the first two moments of their
+ * distributions. With N samples the tolerance on the mean is 5 standard
+ * errors, so a correct sampler essentially never fails. */
+class NativeDistSuite : public CxxTest::TestSuite
+{
+public:
+    NativeDistSuite () : rng(12345, 678) {
+    }
+    
+    void setUp () {
+    }
+    void tearDown () {
+    }
+    
+    void testNormal () {
+        checkMoments( [this]{ return native::std_normal(rng); }, 0.0, 1.0 );
+        // the tail beyond the base layer
+        int n = 0;
+        for( int i = 0; i < N; ++i )
+            if( native::std_normal(rng) > native::ZigguratTables::R ) ++n;
+        const double p = 0.5 * std::erfc( native::ZigguratTables::R / std::sqrt(2.0) );
+        TS_ASSERT_DELTA( double(n) / N, p, 5.0 * std::sqrt(p / N) );
+    }
+    
+    void testGamma () {
+        for( double a : { 0.3, 1.0, 2.5, 20.0 } ){
+            const double b = 2.0;
+            checkMoments( [this,a,b]{ return native::gamma(rng, a, b); }, a*b, a*b*b );
+        }
+    }
+    
+    void testPoisson () {
+        // both sides of the switch from multiplication to PTRS at 10
+        for( double lambda : { 0.5, 4.0, 9.99, 10.0, 30.0, 1000.0 } ){
+            checkMoments( [this,lambda]{ return double(native::poisson(rng, lambda)); }, lambda, lambda );
+        }
+        TS_ASSERT_EQUALS( native::poisson(rng, 0.0), 0 );
+    }
+    
+    void testBeta () {
+        checkMoments( [this]{ return native::beta(rng, 2.0, 3.0); }, 0.4, 0.04 );
+    }
+    
+    void testWeibull () {
+        const double lambda = 2.0, k = 1.5;
+        const double g1 = std::tgamma(1.0 + 1.0 / k), g2 = std::tgamma(1.0 + 2.0 / k);
+        checkMoments( [this,lambda,k]{ return native::weibull(rng, lambda, k); },
+                lambda * g1, lambda * lambda * (g2 - g1 * g1) );
+    }
+    
+private:
+    template<class F>
+    void checkMoments( F sample, double mean, double var ){
+        double sum = 0.0, sumSq = 0.0;
+        for( int i = 0; i < N; ++i ){
+            const double x = sample();
+            sum += x;
+            sumSq += x * x;
+        }
+        const double m = sum / N, v = sumSq / N - m * m;
+        TS_ASSERT_DELTA( m, mean, 5.0 * std::sqrt(var / N) );
+        TS_ASSERT_DELTA( v, var, 0.02 * var );
+    }
+    
+    static const int N = 400000;
+    Xoshiro256P rng;
+};
+
+#endif
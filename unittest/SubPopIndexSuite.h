@@ -0,0 +1,119 @@
+/*
+ This file is part of OpenMalaria.
+ 
+ Copyright (C) 2005-2015 Swiss Tropical and Public Health Institute
+ 
+ OpenMalaria is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or (at
+ your option) any later version.
+ 
+ This program is distributed in the hope that it will be useful, but
+ WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ General Public License for more details.
+ 
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#ifndef Hmod_SubPopIndexSuite
+#define Hmod_SubPopIndexSuite
+
+#include <cxxtest/TestSuite.h>
+#include "Host/SubPopIndex.h"
+#include <vector>
+
+using OM::Host::SubPopIndex;
+
+class SubPopIndexSuite : public CxxTest::TestSuite
+{
+public:
+    void setUp () {
+        SubPopIndex::clear();
+    }
+    void tearDown () {
+        SubPopIndex::clear();
+    }
+    
+    std::vector<uint64_t> members( size_t component, uint64_t first = 0,
+                                   uint64_t last = ~uint64_t(0) ){
+        std::vector<uint64_t> r;
+        SubPopIndex::forEach( component, first, last,
+                              [&]( uint64_t serial ){ r.push_back( serial ); } );
+        return r;
+    }
+    
+    void testAddRemove () {
+        SubPopIndex::add( 2, 70 );
+        SubPopIndex::add( 2, 3 );       // below the first member
+        SubPopIndex::add( 2, 200 );
+        SubPopIndex::add( 2, 70 );      // already listed
+        SubPopIndex::add( 0, 5 );
+        TS_ASSERT_EQUALS( SubPopIndex::count( 2 ), 3u );
+        TS_ASSERT_EQUALS( SubPopIndex::count( 1 ), 0u );
+        TS_ASSERT_EQUALS( SubPopIndex::count( 7 ), 0u );
+        TS_ASSERT( SubPopIndex::contains( 2, 3 ) );
+        TS_ASSERT( !SubPopIndex::contains( 2, 5 ) );
+        TS_ASSERT( SubPopIndex::contains( 0, 5 ) );
+        
+        SubPopIndex::remove( 2, 70 );
+        SubPopIndex::remove( 2, 71 );   // not listed
+        SubPopIndex::remove( 5, 70 );   // unknown component
+        TS_ASSERT_EQUALS( SubPopIndex::count( 2 ), 2u );
+        TS_ASSERT( !SubPopIndex::contains( 2, 70 ) );
+        
+        std::vector<uint64_t> expected = { 3, 200 };
+        TS_ASSERT_EQUALS( members( 2 ), expected );
+    }
+    
+    void testForEachRange () {
+        std::vector<uint64_t> all;
+        for( uint64_t s = 10; s < 1000; s += 7 ){
+            SubPopIndex::add( 1, s );
+            all.push_back( s );
+        }
+        TS_ASSERT_EQUALS( members( 1 ), all );
+        
+        std::vector<uint64_t> part;
+        for( uint64_t s : all ) if( s >= 64 && s < 129 ) part.push_back( s );
+        TS_ASSERT_EQUALS( members( 1, 64, 129 ), part );
+        TS_ASSERT( members( 1, 2000, 3000 ).empty() );
+        TS_ASSERT( members( 1, 11, 17 ).empty() );
+    }
+    
+    void testRemoveWhileIterating () {
+        for( uint64_t s = 0; s < 100; ++s ) SubPopIndex::add( 0, s );
+        size_t n = 0;
+        SubPopIndex::forEach( 0, 0, 100, [&]( uint64_t serial ){
+            if( serial % 2 == 0 ) SubPopIndex::remove( 0, serial );
+            n += 1;
+        } );
+        TS_ASSERT_EQUALS( n, 100u );
+        TS_ASSERT_EQUALS( SubPopIndex::count( 0 ), 50u );
+        TS_ASSERT_EQUALS( members( 0 ).front(), 1u );
+    }
+    
+    void testDiscardBelow () {
+        SubPopIndex::add( 0, 10 );
+        SubPopIndex::add( 0, 1000 );
+        SubPopIndex::remove( 0, 10 );
+        SubPopIndex::discardBelow( 900 );
+        std::vector<uint64_t> expected = { 1000 };
+        TS_ASSERT_EQUALS( members( 0 ), expected );
+        SubPopIndex::add( 0, 950 );
+        expected = { 950, 1000 };
+        TS_ASSERT_EQUALS( members( 0 ), expected );
+        
+        SubPopIndex::remove( 0, 950 );
+        SubPopIndex::remove( 0, 1000 );
+        SubPopIndex::discardBelow( 5000 );
+        SubPopIndex::add( 0, 5000 );
+        TS_ASSERT_EQUALS( SubPopIndex::count( 0 ), 1u );
+        TS_ASSERT( SubPopIndex::contains( 0, 5000 ) );
+    }
+};
+
+#endif
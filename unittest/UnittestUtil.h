@@ -472,6 +472,11 @@ public:
         pkpd.medicateQueue.clear();
     }
     
+    // A single monitoring age group covering all ages
+    static void initAgeGroups(){
+        mon::AgeGroup::upperBound.assign( 1, SimTime::future() );
+    }
+    
     static unique_ptr<Host::Human> createHuman(SimTime dateOfBirth){
         return unique_ptr<Host::Human>( new Host::Human(dateOfBirth, 0) );
     }
@@ -29,7 +29,8 @@ namespace UnitTest {
 
 WHMock::WHMock() :
     totalDensity(numeric_limits<double>::quiet_NaN()),
-    nTreatments(0)
+    nTreatments(0),
+    nCatchUpSteps(0)
 {}
 WHMock::~WHMock() {}
 
@@ -44,6 +45,10 @@ bool WHMock::summarize(Host::Human& human)const{
     throw util::unimplemented_exception( "not needed in unit test" );
 }
 
+void WHMock::catchUpQuiescent(int steps){
+    nCatchUpSteps += steps;
+}
+
 void WHMock::importInfection(LocalRng& rng){
     throw util::unimplemented_exception( "not needed in unit test" );
 }
@@ -60,6 +60,7 @@ public:
     virtual void clearImmunity();
     virtual double getCumulative_h() const;
     virtual double getCumulative_Y() const;
+    virtual void catchUpQuiescent(int steps);
 
     // This mock class does not have actual infections. Just set this as you please.
     double totalDensity;
@@ -70,6 +71,9 @@ public:
     // The last treatment time-spans used by the simple treatment model. SimTime::never() if not used.
     SimTime lastTimeLiver, lastTimeBlood;
     
+    // Total steps passed to catchUpQuiescent(). Read/write this as you like.
+    int nCatchUpSteps;
+    
     // Lists medications and drugs in the body
     PkPd::LSTMModel pkpd;
 
@@ -23,6 +23,7 @@
 
 #include <cxxtest/TestSuite.h>
 #include "util/xoshiro.hpp"
+#include <chacha.h>
 
 class XoshiroSuite : public CxxTest::TestSuite
 {
@@ -51,6 +52,45 @@ public:
             TS_ASSERT_EQUALS(x, vector[n]);
         }
     }
+    
+    void testFillUniform () {
+        Xoshiro256P rng1(1, 2, 3, 4), rng2(1, 2, 3, 4);
+        double buf[37];
+        rng1.fill_uniform(buf, 37);
+        for (int n = 0; n < 37; n++) {
+            TS_ASSERT_EQUALS(buf[n], rng2.gen_double());
+        }
+        TS_ASSERT(rng1 == rng2);
+    }
+    
+    void testSeedFromChaCha () {
+        ChaCha<8> src1(5, 1), src2(5, 1);
+        src1(); src2();     // seed from part-way into a block
+        Xoshiro256P rng1(src1);
+        uint64_t a = src2.gen_u64(), b = src2.gen_u64();
+        uint64_t c = src2.gen_u64(), d = src2.gen_u64();
+        Xoshiro256P rng2(a, b, c, d);
+        TS_ASSERT(rng1 == rng2);
+        TS_ASSERT(src1 == src2);
+    }
+    
+    void testSeedCounter () {
+        Xoshiro256P rng1(1, 2, 3, 4), rng2(5, 6, 7, 8);
+        rng2();
+        // state depends only on the key and counter
+        rng1.seed_counter(17, 42, 1000);
+        rng2.seed_counter(17, 42, 1000);
+        TS_ASSERT(rng1 == rng2);
+        uint64_t x = rng1();
+        TS_ASSERT_EQUALS(x, rng2());
+        
+        rng2.seed_counter(17, 42, 1001);
+        TS_ASSERT_DIFFERS(x, rng2());
+        rng2.seed_counter(18, 42, 1000);
+        TS_ASSERT_DIFFERS(x, rng2());
+        rng2.seed_counter(17, 43, 1000);
+        TS_ASSERT_DIFFERS(x, rng2());
+    }
 };
 
 #endif
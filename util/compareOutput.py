@@ -31,8 +31,8 @@ ABS_PRECISION=1e-6
 
 def charEqual (fn1,fn2):
     MAX=10*1024
-    f1 = open(fn1,'r')
-    f2 = open(fn2,'r')
+    f1 = open(fn1,'rb')
+    f2 = open(fn2,'rb')
     while True:
         s1 = f1.read(MAX)
         s2 = f2.read(MAX)
@@ -19,6 +19,10 @@
 # along with this program; if not, write to the Free Software
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 
+import gzip
+import os
+import struct
+import tempfile
 import unittest
 
 class Keys:
@@ -164,21 +168,7 @@ class ValDict (object):
             self.files.append(fileName)
         else:
             fID = 0
-        fileObj = open(fileName, 'r')
-        nErrs=0
-        for line in fileObj:
-            items=line.split()
-            if (len(items) != 4):
-                print("expected 4 items on line; found (following line):")
-                print(line)
-                nErrs+=1
-                if nErrs>5:
-                    raise Exception ("Too many errors reading "+fileName)
-                continue
-            
-            m=int(items[2])
-            s=int(items[0])
-            g=int(items[1])
+        for (s,g,m,value) in outputRows(fileName,5):
             gt = g / 1000000 # genotype
             g = g - 1000000*gt
             c = g / 1000   # cohort
@@ -199,7 +189,7 @@ class ValDict (object):
                 i+=1
             self.measures.add(m)
             self.nSurveys=max(self.nSurveys,s)
-            self.values[m].add(s,g,c,gt,fID,robustFloat(items[3]))
+            self.values[m].add(s,g,c,gt,fID,value)
     
     def getFiles(self):
         return list(range(len(self.files)))
@@ -273,23 +263,230 @@ def robustFloat(s):
         else:
             raise
 
+BINARY_MAGIC = b"OMOUTBIN"
+
+def openOutput(fname):
+    """Open an output file for reading in binary mode, decompressing if the
+    file is gzip-compressed."""
+    with open(fname, 'rb') as f:
+        start = f.read(2)
+    if start == b'\x1f\x8b':
+        return gzip.open(fname, 'rb')
+    return open(fname, 'rb')
+
+class BinaryMeasure(object):
+    """Description of one measure in a binary output file."""
+    __slots__=["outId","byAge","bySpecies","byDrug","isDouble","dims"]
+    def __init__(self,outId,flags,dims):
+        self.outId = outId
+        self.byAge = (flags & 1) != 0
+        self.bySpecies = (flags & 2) != 0
+        self.byDrug = (flags & 4) != 0
+        self.isDouble = (flags & 8) != 0
+        # number of: cohort sets, age groups, species, genotypes, drugs
+        self.dims = dims
+    def size(self):
+        n = 1
+        for d in self.dims:
+            n *= d
+        return n
+
+class BinaryOutput(object):
+    """Contents of an output file written with --output-format binary (see
+    model/mon/mon.cpp for the format).
+    
+    measures: list of BinaryMeasure
+    cohortIds: output identifier of each cohort set
+    surveys: (list by survey) of (list by measure) of values, with categories
+    in the order of BinaryMeasure.dims (cohort set outermost)
+    imr: (output number, value) or None"""
+    def __init__(self,fileObj):
+        data = fileObj.read()
+        if data[0:8] != BINARY_MAGIC:
+            raise Exception("not a binary output file")
+        # byte order mark
+        if struct.unpack_from('<I',data,8)[0] == 0x01020304:
+            bo = '<'
+        else:
+            bo = '>'
+        pos = 12
+        def read(fmt):
+            nonlocal pos
+            r = struct.unpack_from(bo+fmt,data,pos)
+            pos += struct.calcsize(bo+fmt)
+            return r
+        version,nSurveys,nCohorts = read('III')
+        if version != 1:
+            raise Exception("unsupported binary output version: "+str(version))
+        self.cohortIds = list(read(str(nCohorts)+'I'))
+        nMeasures = read('I')[0]
+        self.measures = list()
+        for i in range(nMeasures):
+            outId,flags = read('iB')
+            self.measures.append(BinaryMeasure(outId,flags,read('5I')))
+        imrId = read('i')[0]
+        self.surveys = list()
+        for s in range(nSurveys):
+            values = list()
+            for m in self.measures:
+                values.append(list(read(str(m.size())+('d' if m.isDouble else 'i'))))
+            self.surveys.append(values)
+        self.imr = (imrId, read('d')[0]) if imrId >= 0 else None
+    
+    def rows(self):
+        """Yield (survey, group, measure, value) for each value, with the same
+        numbering and order as the text output."""
+        for s,values in enumerate(self.surveys):
+            for m,v in zip(self.measures,values):
+                nC,nA,nS,nG,nD = m.dims
+                ageAdd = 1 if m.byAge else 0
+                i = 0
+                for c in range(nC):
+                    for a in range(nA):
+                        for sp in range(nS):
+                            for gt in range(nG):
+                                for d in range(nD):
+                                    if m.bySpecies:
+                                        g = sp + 1 + 1000000*gt
+                                    elif m.byDrug:
+                                        g = a + ageAdd + 1000*self.cohortIds[c] + 1000000*(d+1)
+                                    else:
+                                        g = a + ageAdd + 1000*self.cohortIds[c] + 1000000*gt
+                                    yield (s+1, g, m.outId, v[i])
+                                    i += 1
+        if self.imr is not None:
+            yield (1, 1, self.imr[0], self.imr[1])
+
+def outputRows(fname,maxErrs=None):
+    """Yield (survey, group, measure, value) for each entry of an output file,
+    which may be text or binary and may be gzip-compressed.
+    
+    Malformed text lines are skipped; if maxErrs is given, more than this many
+    cause an exception."""
+    with openOutput(fname) as fileObj:
+        if fileObj.read(len(BINARY_MAGIC)) == BINARY_MAGIC:
+            fileObj.seek(0)
+            for row in BinaryOutput(fileObj).rows():
+                yield row
+            return
+        fileObj.seek(0)
+        nErrs=0
+        for line in fileObj:
+            items=line.decode().split()
+            if (len(items) != 4):
+                print("expected 4 items on line; found (following line):")
+                print(line)
+                nErrs+=1
+                if maxErrs is not None and nErrs>maxErrs:
+                    raise Exception ("Too many errors reading "+fname)
+                continue
+            yield (int(items[0]), int(items[1]), int(items[2]), robustFloat(items[3]))
+
+def isBinaryOutput(fname):
+    """True if fname (which may be gzip-compressed) is binary output."""
+    with openOutput(fname) as fileObj:
+        return fileObj.read(len(BINARY_MAGIC)) == BINARY_MAGIC
+
+def binaryToText(fname,outName):
+    """Convert binary output fname to the text format, formatted as the text
+    writer would (doubles to 6 significant figures), so it can be compared
+    with text output."""
+    with openOutput(fname) as fileObj:
+        output = BinaryOutput(fileObj)
+    with open(outName,'w') as out:
+        for (s,g,m,value) in output.rows():
+            if isinstance(value,int):
+                v = str(value)
+            else:
+                v = '%g' % value
+            out.write("%d\t%d\t%d\t%s\n" % (s,g,m,v))
+
 def readEntries (fname):
     """Return a dict of entries read from file. Keys have type Multi3Keys,
     where a corresponds to measure, b to survey and c to group.
     
     Note: ValDict is probably more efficient due to use of arrays over dicts."""
     values=dict()
-    fileObj = open(fname, 'r')
-    for line in fileObj:
-        items=line.split()
-        if (len(items) != 4):
-            print("expected 4 items on line; found (following line):")
-            print(line)
-            continue
-            
-        key=Multi3Keys(int(items[2]),int(items[0]),int(items[1]))
-        values[key]=robustFloat(items[3])
+    for (s,g,m,value) in outputRows(fname):
+        key=Multi3Keys(m,s,g)
+        values[key]=value
     return values
 
+class TestOutputRows (unittest.TestCase):
+    """Check that binary output (as written by mon::internal::write) reads back
+    as the same rows as the text output of the same store."""
+    # (outId, flags, dims, values by survey); see model/mon/mon.cpp
+    measures = [
+        (0, 1, (2,2,1,1,1), [[10,11,12,13], [20,21,22,23]]),    # by age, two cohort sets
+        (31, 2|8, (1,1,2,1,1), [[0.5,1.25], [2.0,-3.5]]),       # by species, double
+        (1, 1, (1,1,1,2,1), [[3,4], [5,6]]),                    # by genotype
+        (73, 1|4, (1,1,1,1,2), [[7,8], [9,0]]),                 # by drug
+    ]
+    cohortIds = [0, 1]
+    imr = (21, 0.025)
+    text = [
+        "1\t1\t0\t10", "1\t2\t0\t11", "1\t1001\t0\t12", "1\t1002\t0\t13",
+        "1\t1\t31\t0.5", "1\t2\t31\t1.25",
+        "1\t1\t1\t3", "1\t1000001\t1\t4",
+        "1\t1000001\t73\t7", "1\t2000001\t73\t8",
+        "2\t1\t0\t20", "2\t2\t0\t21", "2\t1001\t0\t22", "2\t1002\t0\t23",
+        "2\t1\t31\t2", "2\t2\t31\t-3.5",
+        "2\t1\t1\t5", "2\t1000001\t1\t6",
+        "2\t1000001\t73\t9", "2\t2000001\t73\t0",
+        "1\t1\t21\t0.025",
+    ]
+    
+    def binaryParts(self,bo):
+        """Return the binary output as (header, survey 1, survey 2, IMR)."""
+        header = BINARY_MAGIC + struct.pack(bo+'IIII',0x01020304,1,2,len(self.cohortIds))
+        header += struct.pack(bo+str(len(self.cohortIds))+'I',*self.cohortIds)
+        header += struct.pack(bo+'I',len(self.measures))
+        for outId,flags,dims,values in self.measures:
+            header += struct.pack(bo+'iB5I',outId,flags,*dims)
+        header += struct.pack(bo+'i',self.imr[0])
+        surveys = list()
+        for s in range(2):
+            data = b''
+            for outId,flags,dims,values in self.measures:
+                v = values[s]
+                data += struct.pack(bo+str(len(v))+('d' if flags & 8 else 'i'),*v)
+            surveys.append(data)
+        return [header] + surveys + [struct.pack(bo+'d',self.imr[1])]
+    
+    def rows(self,data):
+        with tempfile.NamedTemporaryFile(delete=False) as f:
+            f.write(data)
+        try:
+            return list(outputRows(f.name,0))
+        finally:
+            os.remove(f.name)
+    
+    def setUp(self):
+        self.expected = self.rows(("\n".join(self.text)+"\n").encode())
+        self.assertEqual(len(self.expected), len(self.text))
+    def testBinary (self):
+        for bo in ['<','>']:
+            self.assertEqual(self.rows(b''.join(self.binaryParts(bo))), self.expected)
+    def testCompressed (self):
+        self.assertEqual(self.rows(gzip.compress(b''.join(self.binaryParts('=')))), self.expected)
+    def testStreamed (self):
+        # --stream-output --compress-output writes each block as a gzip member
+        parts = self.binaryParts('=')
+        members = [parts[0]+parts[1], parts[2]+parts[3]]
+        self.assertEqual(self.rows(b''.join(gzip.compress(m) for m in members)), self.expected)
+        lines = [(l+"\n").encode() for l in self.text]
+        members = [b''.join(lines[:10]), b''.join(lines[10:])]
+        self.assertEqual(self.rows(b''.join(gzip.compress(m) for m in members)), self.expected)
+    def testToText (self):
+        with tempfile.NamedTemporaryFile(delete=False) as f:
+            f.write(gzip.compress(b''.join(self.binaryParts('='))))
+        try:
+            binaryToText(f.name, f.name+".txt")
+            with open(f.name+".txt") as t:
+                self.assertEqual(t.read(), "\n".join(self.text)+"\n")
+            os.remove(f.name+".txt")
+        finally:
+            os.remove(f.name)
+
 if __name__ == '__main__':
     unittest.main()